@@ -61,6 +61,49 @@ const char codeVersion[] = "v2.3.0    04.02.2025";
 
 /*
  Revisions:
+ 2.4.0   (under development)
+                - FEATURE_SERIAL_BENCHMARK: time and LCD traffic for every screen at fixed dates/positions, CSV on serial port
+                -- clock_diagnostics.h: new file for measurements, clock_lcd.h: new file for LCD output layer
+                -- FEATURE_SERIAL_FLOATCOST: also counts sin, cos, sqrt etc per screen and estimates their time (clock_floatcost.h)
+                - FEATURE_SERIAL_BENCHMARK_KERNELS: ns per call of moon, planet, eclipse, calendar computations, JSON on serial port
+                - FEATURE_SERIAL_GOLDEN: text of every screen for fixed dates, time zones, languages, for regression tests by diff
+                - FEATURE_SESSION_RECORD/_REPLAY: GPS bytes, PPS and rotary encoder to/from serial port for reproducing problems
+                -- clock_session.h: new file
+                - FEATURE_TIME_WARP: virtual UTC for all screens, x1...x65535 or as fast as possible, replaces FEATURE_DATE_PER_SECOND
+                - Scratch arena for run-time sized arrays in Reminder(), NextEvents(); WSPR tables in PROGMEM (clock_memory.h)
+                -- FEATURE_DIAGNOSTICS: unused stack by stack painting, scratch arena use, on 2nd page of Diagnostics screen
+                - Build profiles in clock_options.h: only the screens of one subset (or a single screen) are compiled in
+                -- FEATURE_SERIAL_FOOTPRINT: flash, .data, .bss of the build on serial port at startup
+                - Shadow copy of display in clock_lcd.h: only changed characters are sent to the LCD
+                -- Custom characters: lcd.glyph() only uploads a bitmap not already in its CGRAM slot, replaces LCDchar0_3 etc
+                -- LCD_I2C_BATCH: own I2C transport, a run of characters per Wire transaction; LCD_I2C_CLOCK 400 kHz
+                -- Changed characters sent in time slices from loop(), with GPS and rotary encoder read in between
+                - DISPLAY_ON_PPS: next second drawn in advance, shown on 1PPS pulse (clock_display.h), latency on Diagnostics screen
+                - Screen layouts in PROGMEM (clock_layout.h): fields only drawn when their inputs change, first used by TimeZones()
+                - clock_format.h: fixed-width formatting into a line buffer replaces sprintf(), dtostrf() and lcd.print(float)
+                -- PrintFixedWidth() and LcdDate() use it; FEATURE_SERIAL_BENCHMARK_KERNELS times it against sprintf(), dtostrf()
+                - Day names in UTF-8 (clock_options.h), transcoded to LCD ROM codes or custom characters in slots 4-7 (clock_language.h)
+                -- replaces loadNativeCharacters() and the per-language strcmp() tests; Ó now shown in Old Norse "Óðinsdagr"
+                - I2C timeouts: a stuck bus is cleared and the LCD re-initialised with its custom characters (clock_lcd_i2c.h)
+                -- timeouts, write errors, restores on last page of Diagnostics screen
+                - BigNumbers2/3: digit cells from PROGMEM tables, only changed digits redrawn, frame sent in one go (clock_bigdigits.h)
+                -- replaces custom0()...custom9(), draw_digit(), doNumber2()
+                - Clock faces declared once, in FACE_LIST (clock_defines.h): Screen numbers, PROGMEM dispatch table for ScreenSelect()
+                -- replaces the else-if chain; repeated or unknown screens in menuStruct[] are compile errors, no "Invalid screen #"
+                - Refresh cadence per face in FACE_LIST: sun, moon, Hebrew date etc only recomputed when their inputs change
+                -- replaces the oldMinute tests; LocalSun(2) no longer recomputes every second; counts on Diagnostics screen
+                - loop() is a cooperative scheduler (clock_tasks.h): tasks with period, deadline, priority in a PROGMEM table
+                -- GPS and rotary encoder also read from yield() while a face is drawn, e.g. in HebrewDate()
+                -- FEATURE_DIAGNOSTICS: execution time and deadline misses per task in new Tasks screen
+                - Resumable jobs (clock_jobs.h): moon rise/set, lunar eclipses, planets, Hebrew date computed in slices of a few ms
+                -- faces show the last result or "..." until done; MoonRiseSet() once per day instead of every minute
+                - Demo mode plays a playlist (clock_demo.h): "shuffle" shows each face once per round, replaces "random"
+                -- dwell per face in FACE_LIST, e.g. 20 s for faces which alternate; jobs of the next face started in advance
+                -- no more compensation for the time of ISOHebIslam(), which no longer blocks
+                - FEATURE_PROFILER: min/mean/p99/max execution time per screen, worst ones shown in new Profiler screen
+                - FEATURE_DIAGNOSTICS: max time between readGPS() calls, UART buffer overflow, GPS checksum errors, lost $GPGSV
+                -- shown in new Diagnostics screen and on serial port, with the screen that was shown when it happened
+
  2.3.0   04.02.2025 (incorrectly called 2.2.2)
                 - Replaced legacy library, NewLiquidCrystal_lib, <LiquidCrystal_I2C.h> with standard library <hd44780.h>  
                 - Progress screen showing progress bar for day of week (1-7), and for day/month of year (1-12)
@@ -267,6 +310,8 @@ One routine per clock face, i.e. one per menu item:
 
             InternalTime
             CodeStatus
+            Profiler
+            Diagnostics
 
             UTCPosition
 
@@ -314,7 +359,7 @@ One routine per clock face, i.e. one per menu item:
 #define EEPROM_OFFSET1 0    // first address for setup info in EEPROM, adresses used: EEPROM_OFFSET1 ... EEPROM_OFFSET1+9
 #define EEPROM_OFFSET2 100  // first address for birthday info for Reminder()
 
-#define noOfScreens 50  // must be large enough to hold all possible screens in menu!!
+#define noOfScreens 53  // must be large enough to hold all possible screens in menu!!
 #define NUMBER_OF_TIME_ZONES 20  // no of time zones defined in clock_timezone.h
 
 #define RAD (PI / 180.0)
@@ -379,13 +424,17 @@ Timezone tz;  // holds currently selected timezone
     #include <hd44780.h>
     #include <hd44780ioClass/hd44780_I2Cexp.h>  // i2c expander i/o class header:  OK
   #endif
+  #include "clock_lcd_i2c.h"  // I2C timeouts and bus recovery; LCD_I2C_BATCH: batched transport instead of hd44780_I2Cexp
 #endif
 
 #if defined(FEATURE_LCD_4BIT)
   #include <LiquidCrystal.h>
 #endif
 
+#include "clock_lcd.h"  // LCD output layer: LCD_TYPE() wraps the library class below in a shadow copy of the display
+
 #include <rotary.h>  // rotary handler https://bitbucket.org/Dershum/rotary_button/src/master/
+#include "clock_session.h"  // record/replay of GPS, PPS and rotary encoder: ROTARY_TYPE wraps Rotary when needed
 #include <moon2.h>   // via https://github.com/k3ng/k3ng_rotator_controller/tree/master/libraries
 //                      "Translated from the WSJT Fortran code by Pete VE5VA"
 
@@ -393,41 +442,28 @@ Timezone tz;  // holds currently selected timezone
 //            set the LCD address to 0x27 and set the pins on the I2C chip used for LCD connections:
 //                     addr, en,rw,rs,d4,d5,d6,d7,bl,blpol
   #ifdef OLD_LCD_LIBRARY
-    LiquidCrystal_I2C lcd(0x27, 2, 1, 0, 4, 5, 6, 7, 3, POSITIVE);  // Set the LCD I2C address
+    LCD_TYPE(LiquidCrystal_I2C) lcd(0x27, 2, 1, 0, 4, 5, 6, 7, 3, POSITIVE);  // Set the LCD I2C address
+  #elif defined(LCD_I2C_BATCH)
+    LCD_TYPE(LcdI2cBatch) lcd;                  // fixed address and wiring, see clock_hardware.h
   #else
-    hd44780_I2Cexp lcd;               // declare lcd object: auto locate & auto config expander chip
+    LCD_TYPE(hd44780_I2Cexp) lcd;               // declare lcd object: auto locate & auto config expander chip
   #endif
 #endif
 
 #if defined(FEATURE_LCD_4BIT)
-  LiquidCrystal lcd(lcd_rs, lcd_enable, lcd_d4, lcd_d5, lcd_d6, lcd_d7);
+  LCD_TYPE(LiquidCrystal) lcd(lcd_rs, lcd_enable, lcd_d4, lcd_d5, lcd_d6, lcd_d7);
 #endif
 
 #define NCOLS 20  // LCD
 #define NROWS 4   // LCD
 
-Rotary r = Rotary(PIN_A, PIN_B, PUSHB);  // Initialize the Rotary object
-
-byte LCDchar0_3 = 0; // 0 means unknown status
-byte LCDchar4_5 = 0;
-byte LCDchar6_7 = 0;
-#define LCDARROWS  1 // for LCDchar0_3
-#define LCDNATIVE  2 // for LCDchar4_5, LCDchar6_7
-#define LCD3WIDE   3 // for LCDchar0_3, LCDchar4_5, LCDchar6_7
-#define LCD3HIGH   4 // for LCDchar0_3, LCDchar4_5, LCDchar6_7
-#define LCDGAPLESS 5 // for LCDchar0_3, LCDchar4_5 
-#define LCDBARS    6 // for LCDchar4_5
-#define LCDARING   7 // for LCDchar6_7
-#define LCDFRAMEDBARS 8 
-
-byte buffer[8];  // temporary storage for PROGMEM characters before writing to LCD
+ROTARY_TYPE r = ROTARY_TYPE(PIN_A, PIN_B, PUSHB);  // Initialize the Rotary object
 
 static uint32_t gpsBaud;  // stores baud rate for GPS, read from gpsBaud1 - array
 int dispState;            // depends on rotary, decides which screen to display
+int currentScreen = -1;   // Screen number (clock_defines.h) of screen being shown, also in demo mode
 int demoDispState;        // decides what to display in Demo Mode
-int previousDemoDispState = 1000; // remember old Demo screen, in order not to repeat same screen again in random mode
 int demoDuration = 0;     // counter for time between Demo screens
-unsigned int elapsedTime;          // milliseconds in function routine (only used in ISOHebIslam()) in order get time between demo screens right
 
 char today[15];           // for storing string with day name 
 char todayFormatted[15];  // for storing string with day name up to 12 characters long
@@ -451,6 +487,7 @@ int oldMinute = -1;  // compared to minuteGPS in order to get immediate display
 int yearGPS;
 uint8_t monthGPS, dayGPS, hourGPS, minuteGPS, secondGPS, weekdayGPS;
 volatile byte pps = 0;  // GPS one-pulse-per-second flag
+volatile uint32_t ppsMicros = 0;  // micros() at last pulse, for pulse-to-glass latency
 
 /*
   Uses Serial1 for GPS input
@@ -460,6 +497,7 @@ volatile byte pps = 0;  // GPS one-pulse-per-second flag
 */
 TinyGPSPlus gps;  // The TinyGPS++ object
 
+#include "clock_floatcost.h"   // counting of math function calls with FEATURE_SERIAL_FLOATCOST, after the libraries
 #include "clock_z_planets.h"   // moved from line 318 to here 22.09.2024, must be down here to read longitude correct in clock_z_planets.h
 #include "clock_z_lunarCycle.h"
 
@@ -473,14 +511,14 @@ int8_t timeZoneNumber = 0;  // variable for choosing time zone
 
 // Initial values for secondary menu parameter - stored in EEPROM
 int8_t baudRateNumber = 1;     // points to entry in array of possible baudrates
-int8_t demoStepType = 0;       // step type in demo (increase +, decrease -, random)
+int8_t demoStepType = 0;       // step type in demo (increase +, decrease -, shuffle), see clock_demo.h
 int8_t dwellTimeDemo = 10;     // no of seconds per screen as DemoClock cycles through all screen
 int8_t secondsClockHelp = 6;   // no of seconds per minute of normal clock display for fancy clocks
 int8_t mathSecondPeriod = 10;  // 1...6 per minute, i.e. 10-60 seconds in AlbertClock app
 int8_t firstDayWeek     = 2;   // 1 for Sunday, 2 for Monday, ... 
 boolean using_PPS = false;     // toggle use of PPS pulse from GPS for interrupt and more accurate timeing
 
-char demoStepTypeText[][7] = {"+", "-", "random"}; // hard-coded index range 0..2 for demoStepType here and there in code
+char demoStepTypeText[][8] = {"+", "-", "shuffle"}; // hard-coded index range 0..2 for demoStepType here and there in code
 
 
 
@@ -531,43 +569,83 @@ struct
 float SNRAvg = 0.0;
 int totalSats = 0;
 
-#ifdef FEATURE_DATE_PER_SECOND  // for stepping date quickly and check calender function
-  int dateIteration;
-#endif
-
+#include "clock_format.h"           // fixed-width formatting into a line buffer, instead of sprintf()
 #include "clock_language.h"         // user customable functions and character sets for multiple local languages, was "clock_custom_routines.h"
+#include "clock_bigdigits.h"        // big digits over several lines, only drawn where they have changed
 #include "clock_helper_routines.h"  // library of functions
+#include "clock_memory.h"           // scratch arena for temporary arrays, stack measurement
 
 #include "clock_z_moon_eclipse.h"
 #include "clock_z_equatio.h"
+#include "clock_jobs.h"         // resumable computations, advanced in slices from loop()
+#include "clock_layout.h"       // screen layouts in PROGMEM, fields only drawn when their inputs change
+#include "clock_display.h"      // display timing: next second in advance with DISPLAY_ON_PPS, pulse-to-glass latency
+#include "clock_diagnostics.h"  // benchmark and other measurements
+#include "clock_tasks.h"        // cooperative scheduler for loop(), see the task table above loop()
+#include "clock_demo.h"         // demo mode: playlist, prefetch of the next face
 
 //#include "clock_development.h"  // uncomment if new function is under development
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 void readGPS() {
   // ******** start gps time update
-  #ifndef FEATURE_FAKE_SERIAL_GPS_IN
+  #ifdef FEATURE_DIAGNOSTICS
+    #ifndef FEATURE_FAKE_SERIAL_GPS_IN
+      DiagnosticsReadGPS(Serial1.available());
+    #else
+      DiagnosticsReadGPS(Serial.available());
+    #endif
+  #endif
+
+  #if defined(FEATURE_SESSION_REPLAY)
+    SessionReplay();                              // GPS, PPS and rotary encoder from recorded session
+
+  #elif !defined(FEATURE_FAKE_SERIAL_GPS_IN)      // normal mode:
     while (Serial1.available()) {
-      if (gps.encode(Serial1.read())) {           // process gps messages from hw GPS (default mode)
+      char c = Serial1.read();
+      #ifdef FEATURE_SESSION_RECORD
+        SessionRecordGPS(c);
+      #endif
+      GPSEncode(c);                               // process gps messages from hw GPS (default mode)
+    }    // while (Serial1.available())
 
-  #else  // normal mode:
+  #else
     while (Serial.available()) {
-      if (gps.encode(Serial.read())) {            // process gps messages from sw GPS emulator
-  #endif 
-      }  // (gps.encode(Serial.read()))
+      GPSEncode(Serial.read());                   // process gps messages from sw GPS emulator
     }    // while (Serial.available())
+  #endif 
+}
+
+void GPSEncode(char c) {  // one character from the GPS, or from a replayed session
+  #ifdef FEATURE_DIAGNOSTICS
+    boolean sentence = gps.encode(c);  // true when a sentence with valid checksum has been decoded
+    if (sentence) DiagnosticsSentence();
+  #else
+    gps.encode(c);
+  #endif
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
 void syncCheck() {                         // from GPS_Clock_triple.ino by Bruce E. Hall, w8bh.net
+#ifdef FEATURE_SESSION_RECORD
+  if (pps) SessionRecordPPS();
+#endif
+#ifdef FEATURE_TIME_WARP
+  TimeWarpStep();                          // virtual time instead of GPS time
+#else
   if (pps || (!using_PPS)) syncTimeGPS();  // is it time to sync with GPS?
+#endif
+#ifdef DISPLAY_ON_PPS
+  if (pps) ppsSeen = true;                 // releases the frame drawn in advance, see updateDisplay()
+#endif
   pps = 0;                                 // reset flag, regardless
 }
 //////////////////////////////////////////////////
 //                                                    from GPS_Clock_triple.ino by Bruce E. Hall, w8bh.net
 void ppsHandler() {  // 1pps interrupt handler:
   pps = 1;           // flag that signal was received
+  ppsMicros = micros();
   #ifdef FEATURE_INTERRUPTTEST
     state = !state; // for Built in LED
   #endif
@@ -620,73 +698,95 @@ void syncTimeGPS() {
 ////////////////////////////////////////////////////////////////////////////////
 void updateDisplay() {
   if (timeStatus() != timeNotSet) {
+#ifdef DISPLAY_ON_PPS
+    if (DisplayHeld()) return;     // next second drawn in advance, waiting for the pulse
+#endif
     if (now() != prevDisplay) {  //update the display only if the time has changed. i.e. every second
       prevDisplay = now();
+      DrawScreen();
+      lcd.endFrame();              // only changed characters are sent to the display, by lcd.drain() in loop()
+      DisplayEdge();
+    }  // if (now() != prevDisplay)
+#ifdef DISPLAY_ON_PPS
+    else DisplayAhead();           // draws the next second as soon as this one has been sent
+#endif
+  }    // if (timeStatus() != timeNotSet)
+}
 
-      if (demoDispState == menuOrder[ScreenISOHebIslam])                // new 09.10.2024
-	    // int(elapsedTime/1000.): Arduino Mega a bit slow. With int(round(elapsedTime/1000.)): a bit too fast
-        demoDuration = min(demoDuration + 1 + int(elapsedTime/1000.0), 10000); // limit it in order not to overflow
-      else
-        demoDuration = min(demoDuration + 1, 10000);                 // limit it in order not to overflow
+////////////////////////////////////////////////////////////////////////////////
 
-      // this is for jumping from screen to screen in demo Mode:
-      if ((dispState == menuOrder[ScreenDemoClock]) && (demoDuration >= dwellTimeDemo))  // demo mode: increment screen number, new 30.8.2023
-      {
-        if (demoStepType == 1)
-          demoDispState -= 1;                       // decrement screen number in demo mode                              
-        else if (demoStepType == 2)         
-        {
-          do  {                                         // 09.10.2024: check to avoid same draw
-              demoDispState = random(0, noOfStates-1);  // random choice of screen number in demo mode (noOfStates-1 in order not to recursively select demo Mode itself)
-              } while (demoDispState == previousDemoDispState);
-          previousDemoDispState = demoDispState;  //save the currently chosen demoDispState so we don't repeat it
-        }
-        else
-          demoDispState += 1;                     // increment screen number in demo mode
+void DrawScreen() {  // draws the screen for now() into the shadow copy of the display, sent after lcd.endFrame()
+  lcd.beginFrame();  // first, so that lcd.clear() below only clears the shadow copy
+  demoDuration = min(demoDuration + 1, 10000);  // limit it in order not to overflow
 
-        if (demoDispState < 0) demoDispState += noOfStates;  // but not below the lowest number
-        demoDispState = demoDispState % noOfStates;          // or above the largest number
+  // this is for jumping from screen to screen in demo Mode:
+  if (InDemo() &&
+      (demoDuration >= FaceDwell(menuStruct[subsetMenu].order[demoDispState])))  // demo mode: next screen, new 30.8.2023
+  {
+    demoDispState = DemoNext();  // next one in the playlist, clock_demo.h
 #ifdef FEATURE_SERIAL_MENU
-        Serial.print(F("demoDispState "));
-        Serial.println(demoDispState);
-        Serial.print(F("dispState "));
-        Serial.print(dispState);
-        Serial.print(", ");
-        Serial.print(menuOrder[ScreenDemoClock]);
-        Serial.print(F(", oldMinute "));
-        Serial.println(oldMinute);
-        //            Serial.print(F("now() ")); Serial.println(now());
-        //            Serial.print(minute(now())); Serial.print(":");Serial.println(second(now()));
-        //Serial.print(F("demoDuration "));
-        //Serial.println(demoDuration);
-        Serial.println(" ");
+    Serial.print(F("demoDispState "));
+    Serial.println(demoDispState);
+    Serial.print(F("dispState "));
+    Serial.print(dispState);
+    Serial.print(", ");
+    Serial.print(menuOrder[ScreenDemoClock]);
+    Serial.print(F(", oldMinute "));
+    Serial.println(oldMinute);
+    //            Serial.print(F("now() ")); Serial.println(now());
+    //            Serial.print(minute(now())); Serial.print(":");Serial.println(second(now()));
+    //Serial.print(F("demoDuration "));
+    //Serial.println(demoDuration);
+    Serial.println(" ");
 #endif
-        demoDuration = 0;  // reset counter of seconds between demo screen
-        lcd.clear();       // clear if demo just started ? - no, happens every time
-        oldMinute = -1;    // to get immediate display of some info. Moved here 27.6.2023
-      }
+    demoDuration = 0;  // reset counter of seconds between demo screen
+    lcd.clear();       // clear if demo just started ? - no, happens every time
+    oldMinute = -1;    // to get immediate display of some info. Moved here 27.6.2023
+  }
 
-      ////////////////////////////////////////// USER INTERFACE /////////////////////////////////////////////////////////
+  ////////////////////////////////////////// USER INTERFACE /////////////////////////////////////////////////////////
 #ifdef FEATURE_SERIAL_MENU
-      //Serial.print(F("dispState ")); Serial.println(dispState);
-      //Serial.println((dispState % noOfStates));
-      //Serial.println(menuOrder[dispState % noOfStates]);
+  //Serial.print(F("dispState ")); Serial.println(dispState);
+  //Serial.println((dispState % noOfStates));
+  //Serial.println(menuOrder[dispState % noOfStates]);
 #endif
 
-      ////////////// This is the order of the menu system unless menuOrder[] contains information to the contrary
+  ////////////// This is the order of the menu system unless menuOrder[] contains information to the contrary
 
-      ScreenSelect(dispState, 0);  // select right routine for chosen screen, 0 = ordinary, i.e. not demo mode
+  if (InDemo())  // the screen shown, not DemoClock, for profiling and diagnostics
+    currentScreen = menuStruct[subsetMenu].order[demoDispState];
+  else
+    currentScreen = menuStruct[subsetMenu].order[dispState];
 
-    }  // if (now() != prevDisplay)
-  }    // if (timeStatus() != timeNotSet)
-}
+#if defined(FEATURE_PROFILER) || defined(FEATURE_TIME_WARP)
+  uint32_t startTime = micros();
+#endif
+
+  ScreenSelect(dispState, 0);  // select right routine for chosen screen, 0 = ordinary, i.e. not demo mode
+  if (InDemo()) DemoPrefetch();  // jobs of the next face, after those of this one
 
+#ifdef FEATURE_PROFILER
+  ProfilerRecord(currentScreen, micros() - startTime);
+#endif
+#ifdef FEATURE_TIME_WARP
+  TimeWarpRecord(currentScreen, micros() - startTime);
+#endif
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 
+unsigned char encoderResult = 0;  // rotation found by EncoderSample(), waiting for checkEncoder()
+
+void EncoderSample()  // read rotation of rotary encoder, also from yield() while a face is being drawn
+{
+  unsigned char result = r.process();
+  if (result) encoderResult = result;
+}
+
 void checkEncoder()  // check and read rotation and button of rotary encoder
 {
-  volatile unsigned char rotaryResult = r.process();
+  unsigned char rotaryResult = encoderResult;
+  encoderResult = 0;
   if (rotaryResult)  // change clock face number by rotation
   {
     if (rotaryResult == DIR_CCW)  // Counter clockwise: decrease screen number
@@ -710,9 +810,8 @@ void checkEncoder()  // check and read rotation and button of rotary encoder
     oldMinute = -1;  // to get immediate display of some info
     lcd.setCursor(18, 3);
     PrintFixedWidth(lcd, dispState, 2);  // screen number temporarily in lower right-hand corner
-    if (dispState == menuOrder[ScreenDemoClock]) {
-      demoDispState = dispState;  // start demo
-      demoDuration = 0;           // reset timer for time between screens in demo mode
+    if (InDemo()) {
+      DemoStart();
     }
   }
 
@@ -739,11 +838,11 @@ void checkEncoder()  // check and read rotation and button of rotary encoder
 
   if (r.buttonPressedReleased(25))  // 25 ms debounce_delay = short press to enter setup menu
   {
-    // make sure native characters are loaded (for local language display in RotarySetup)
-    loadNativeCharacters(languageNumber);
-
     RotarySetup();   // call setup
     oldMinute = -1;  // to get immediate display of some info.  09.08.2023
+    #ifdef FEATURE_DIAGNOSTICS
+      lastReadGPS = 0;  // don't count time in setup menu as loop time
+    #endif
   }
 }
 
@@ -753,9 +852,8 @@ void readButtons()      // read separate buttons (not the one in rotary encoder)
   byte button = AnalogButtonRead(0);  // using K3NG function
   if (button == 2) {                  // increase menu # by one
     dispState = (dispState + 1) % noOfStates;
-    if (dispState == menuOrder[ScreenDemoClock]) {
-      demoDispState = dispState;  // start demo
-      demoDuration = 0;           // reset timer for time between screens in demo mode
+    if (InDemo()) {
+      DemoStart();
     }
     lcd.clear();
     oldMinute = -1;  // to get immediate display of some info
@@ -767,9 +865,8 @@ void readButtons()      // read separate buttons (not the one in rotary encoder)
     dispState = (dispState - 1) % noOfStates;
     ;
     if (dispState < 0) dispState += noOfStates;
-    if (dispState == menuOrder[ScreenDemoClock]) {
-      demoDispState = dispState;  // start demo
-      demoDuration = 0;           // reset timer for time between screens in demo mode
+    if (InDemo()) {
+      DemoStart();
     }
     lcd.clear();
     oldMinute = -1;  // to get immediate display of some info
@@ -782,87 +879,109 @@ void readButtons()      // read separate buttons (not the one in rotary encoder)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// Dispatch table built from FACE_LIST (clock_defines.h): one entry per Screen number, in PROGMEM. The draw function of
+// a face left out by a build profile is empty, so that the face is not linked in
+
+#ifdef FEATURE_PROFILER
+  #define FACE_PROFILER Profiler()
+#else
+  #define FACE_PROFILER (void)0
+#endif
+#ifdef FEATURE_DIAGNOSTICS
+  #define FACE_DIAGNOSTICS Diagnostics()
+  #define FACE_TASKS Tasks()
+#else
+  #define FACE_DIAGNOSTICS (void)0
+  #define FACE_TASKS (void)0
+#endif
+
+#ifdef FEATURE_SERIAL_BENCHMARK
+  #define FACE_NAMES  // names in flash, for the output of BenchmarkScreens()
+#endif
+
+struct Face
+{
+  void (*draw)(byte demoMode);
+  void (*prefetch)();           // starts the jobs of the face ahead of time, in demo mode
+  uint8_t needs;                // FACE_LOCATION | FACE_GLYPHS
+  uint8_t refresh;              // LAYOUT_SECOND | ..., for CadenceBegin()
+  uint8_t period;               // seconds, for LAYOUT_TOGGLE
+  uint8_t dwell;                // least no of seconds in demo mode
+#ifdef FACE_NAMES
+  const char *name;             // PROGMEM
+#endif
+};
+
+#define FACE_DRAW(id, draw, name, needs, refresh, period, dwell, prefetch) \
+  void Draw##id(byte demoMode) { if (IN_BUILD(id)) draw; } \
+  void Prefetch##id() { if (IN_BUILD(id)) prefetch; }
+FACE_LIST(FACE_DRAW)
+
+#ifdef FACE_NAMES
+  #define FACE_NAME(id, draw, name, needs, refresh, period, dwell, prefetch) const char Name##id[] PROGMEM = name;
+  FACE_LIST(FACE_NAME)
+  #define FACE_ENTRY(id, draw, name, needs, refresh, period, dwell, prefetch) \
+    {Draw##id, Prefetch##id, needs, refresh, period, dwell, Name##id},
+#else
+  #define FACE_ENTRY(id, draw, name, needs, refresh, period, dwell, prefetch) \
+    {Draw##id, Prefetch##id, needs, refresh, period, dwell},
+#endif
+
+const Face faces[noOfFaces] PROGMEM = {FACE_LIST(FACE_ENTRY)};  // in the order of the Screen numbers
+
+uint8_t FaceNeeds(int screen)  // FACE_LOCATION | FACE_GLYPHS
+{
+  return pgm_read_byte(&faces[screen].needs);
+}
+
+uint8_t FaceDwell(int screen)  // seconds in demo mode, at least dwellTimeDemo
+{
+  return max(uint8_t(dwellTimeDemo), uint8_t(pgm_read_byte(&faces[screen].dwell)));
+}
+
+void FacePrefetch(int screen)  // starts the jobs of the face, see clock_demo.h
+{
+  void (*prefetch)() = (void (*)())pgm_read_ptr(&faces[screen].prefetch);
+  prefetch();
+}
+
+#ifdef FACE_NAMES
+const __FlashStringHelper *FaceName(int screen)  // for Serial.print()
+{
+  return (const __FlashStringHelper *)pgm_read_ptr(&faces[screen].name);
+}
+#endif
+
+/*****
+Purpose:
+Draws the face at a position of the chosen subset of the menu: one lookup in menuStruct[] and one in faces[]
+No run time check is needed, as menuStruct[] is checked at compile time (clock_options.h)
+CadenceBegin() tells the face whether its expensive part must be recomputed, see faceRecompute in clock_layout.h
+
+Argument List: int disp = position in menuStruct[subsetMenu], 0...noOfStates-1
+               int DemoMode = 0: ordinary, 1: called from DemoClock()
+
+Return value: Displays on LCD
+*****/
+
 void ScreenSelect(int disp, int DemoMode)  // menu System - called from inside loop [from updateTime()] and from DemoClock
 {
-  if (disp == menuOrder[ScreenLocalUTC])                LocalUTC(0);            // local time, date; UTC, locator
-  else if (disp == menuOrder[ScreenLocalUTCWeek])       LocalUTC(1);            // local time, date; UTC, week #
-  else if (disp == menuOrder[ScreenUTCLocator])         UTCLocator(1);          // UTC, locator, # sats
-
-  // Sun, moon:
-  else if (disp == menuOrder[ScreenLocalSun])           LocalSun(0);            // local time, sun x 3
-  else if (disp == menuOrder[ScreenLocalSunMoon])       LocalSunMoon();         // local time, sun, moon
-  else if (disp == menuOrder[ScreenLocalMoon])          LocalMoon();            // local time, moon size and elevation
-  else if (disp == menuOrder[ScreenMoonRiseSet])        MoonRiseSet();          // Moon rises and sets at these times
-
-  // Nice to have
-  else if (disp == menuOrder[ScreenTimeZones])          TimeZones();            // Other time zones
-
-  // Fancy, sometimes near unreadable displays, fun to program, and fun to look at:
-  else if (disp == menuOrder[ScreenBinary])             Binary(2);              // Binary, horizontal, display of time
-  else if (disp == menuOrder[ScreenBinaryHorBCD])       Binary(1);              // BCD, horizontal, display of time
-  else if (disp == menuOrder[ScreenBinaryVertBCD])      Binary(0);              // BCD vertical display of time
-  else if (disp == menuOrder[ScreenBar])                Bar();                  // horizontal bar
-  else if (disp == menuOrder[ScreenMengenLehrUhr])      MengenLehrUhr();        // set theory clock
-  else if (disp == menuOrder[ScreenLinearUhr])          LinearUhr();          // Linear clock
-  // debugging:
-  else if (disp == menuOrder[ScreenInternalTime])       InternalTime();       // Internal time - for debugging
-  else if (disp == menuOrder[ScreenCodeStatus])         CodeStatus();         //
-
-  // GPS Location
-  else if (disp == menuOrder[ScreenUTCPosition])        UTCPosition();        // position
-
-  // WSPR and beacons:
-  else if (disp == menuOrder[ScreenNCDXFBeacons2])      NCDXFBeacons(2);      // UTC + NCDXF beacons, 18-28 MHz
-  else if (disp == menuOrder[ScreenNCDXFBeacons1])      NCDXFBeacons(1);      // UTC + NCDXF beacons, 14-21 MHz
-  else if (disp == menuOrder[ScreenWSPRsequence])       WSPRsequence();  // UTC + Coordinated WSPR band/frequency (20 min cycle)
-
-  else if (disp == menuOrder[ScreenHex])                HexOctalClock(0);     // Hex clock
-  else if (disp == menuOrder[ScreenOctal])              HexOctalClock(1);     // Octal clock
-  else if (disp == menuOrder[ScreenHexOctalClock])      HexOctalClock(3);     // 3-in-1: Hex-Octal-Binary clock
-
-  else if (disp == menuOrder[ScreenEasterDates])        EasterDates(yearGPS); // Gregorian and Julian Easter Sunday
-
-  else if (disp == menuOrder[ScreenLocalSunSimpler])    LocalSun(2);          // local time, sun x 3 - simpler layout
-  else if (disp == menuOrder[ScreenLocalSunAzEl])       LocalSunAzEl();       // local time, sun az, el
-
-  else if (disp == menuOrder[ScreenRoman])              Roman();              // Local time in Roman numerals
-  else if (disp == menuOrder[ScreenMathClockAdd])       MathClock(0);         // Math clock: add
-  else if (disp == menuOrder[ScreenMathClockSubtract])  MathClock(1);         // Math clock: subtract/add
-  else if (disp == menuOrder[ScreenMathClockMultiply])  MathClock(2);         // Math clock: multiply/subtract/add
-  else if (disp == menuOrder[ScreenMathClockDivide])    MathClock(3);         // Math clock: divide/multiply/subtract
-
-  else if (disp == menuOrder[ScreenLunarEclipse])       LunarEclipse();       // time for lunar eclipse
-  else if (disp == menuOrder[ScreenSidereal])           Sidereal();           // sidereal and solar time
-  else if (disp == menuOrder[ScreenMorse])              Morse();              // morse time
-  else if (disp == menuOrder[ScreenWordClock])          WordClock();          // time in clear text
-  else if (disp == menuOrder[ScreenGPSInfo])            GPSInfo();            // Show technical GPS Info
-  else if (disp == menuOrder[ScreenISOHebIslam])        ISOHebIslam();        // ISO, Hebrew, Islamic calendar
-  else if (disp == menuOrder[ScreenPlanetsInner])       PlanetVisibility(1);  // Inner planet data
-  else if (disp == menuOrder[ScreenPlanetsOuter])       PlanetVisibility(0);  // Inner planet data
-  else if (disp == menuOrder[ScreenChemical])           LocalUTC(2);          // local time + chemical element
-
-  else if (disp == menuOrder[ScreenBigNumbers2])        BigNumbers2(0);       // local time with big numbers
-  else if (disp == menuOrder[ScreenBigNumbers2UTC])     BigNumbers2(1);       // UTC with big numbers
-  else if (disp == menuOrder[ScreenBigNumbers3])        BigNumbers3(0);       // local time with big numbers
-  else if (disp == menuOrder[ScreenBigNumbers3UTC])     BigNumbers3(1);       // UTC with big numbers
-  else if (disp == menuOrder[ScreenReminder])           Reminder();           // Show dates to remember and elapsed time (from EEPROM) 
-  else if (disp == menuOrder[ScreenEquinoxes])          Equinoxes();          // Show equinoxes, solstices
-  else if (disp == menuOrder[ScreenSolarEclipse])       SolarEclipse();       // time for solar eclipses
-  else if (disp == menuOrder[ScreenNextEvents])         NextEvents();         // Show next Easter, eclipse(s), equinox/solstice in sorted order
-
-  else if (disp == menuOrder[ScreenProgress])           Progress();           // Date, time, progress bars for week, month, year 
-  
-  else if (disp == menuOrder[ScreenDemoClock])  // last menu item
-  {
-    if (!DemoMode)                                      DemoClock(0);         // Start demo of all clock functions if not already in DemoMode
-    else                                                DemoClock(1);         // continue with demo mode
-  } else                          // Error handling, added 12.7.2023
+  ScratchReset();  // temporary arrays of previous screen are no longer in use
+
+  int screen = menuStruct[subsetMenu].order[disp];
+  const Face *face = &faces[screen];
+  void (*draw)(byte) = (void (*)(byte))pgm_read_ptr(&face->draw);
+  uint8_t refresh = pgm_read_byte(&face->refresh);
+
+  if (refresh == 0)  // DemoClock(), which calls ScreenSelect() for the face it shows
   {
-    lcd.setCursor(0, 0);
-    lcd.print(F("Warning:"));
-    lcd.setCursor(0, 1);
-    lcd.print(F("  Invalid screen #"));  // due to repeated entry in menuStruct[]
+    draw(DemoMode != 0);
+    return;
   }
+
+  CadenceBegin(face, refresh, pgm_read_byte(&face->period));
+  draw(DemoMode != 0);
+  oldMinute = minuteGPS;  // for faces without a cadence of their own
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -969,7 +1088,14 @@ void readEEPROM() {
 
 void setup() {
 
+#ifdef FEATURE_DIAGNOSTICS
+  StackPaint();  // first, so all later stack use is measured
+#endif
+
   lcd.begin(20, 4);
+#if defined(FEATURE_LCD_I2C)
+  I2cBusSetup();  // after begin(), as the library starts the bus at the default speed
+#endif
   digitalWrite(PIN_A, HIGH);  // enable pull-ups for rotary encoder and button
   digitalWrite(PIN_B, HIGH);
   digitalWrite(PUSHB, HIGH);
@@ -1024,7 +1150,9 @@ void setup() {
       Serial.begin(gpsBaud);            // for faking GPS data from software simulator
   #endif
 
+#ifndef FEATURE_SESSION_REPLAY  // PPS comes from recorded session
   attachInterrupt(digitalPinToInterrupt(GPS_PPS), ppsHandler, RISING);  // enable 1pps GPS time sync
+#endif
  // works here for METRO: https://forum.arduino.cc/t/interrupt-not-being-called-in-arduino-m0-pro/485356 
 
   CodeStatus();  // show start screen
@@ -1103,24 +1231,60 @@ void setup() {
   Serial.println(F("Character set debug"));
 #endif
 
-#ifdef FEATURE_DATE_PER_SECOND  // for stepping date quickly and check calender function
-  dateIteration = 0;
+#ifdef FEATURE_DIAGNOSTICS
+  Serial.begin(115200);
+  Serial.println(F("Diagnostics"));
+#endif
+
+#ifdef FEATURE_SERIAL_BENCHMARK
+  Serial.begin(115200);
+  Serial.println(F("Benchmark of screens, starts after GPS fix"));
+#endif
+
+#if defined(FEATURE_SESSION_RECORD) || defined(FEATURE_SESSION_REPLAY)
+  SessionStart();
+#endif
+
+#ifdef FEATURE_SERIAL_GOLDEN
+  Serial.begin(115200);
+  Serial.println(F("Golden frames of screens, starts after GPS fix"));
+#endif
+
+#ifdef FEATURE_TIME_WARP
+  #ifndef FEATURE_FAKE_SERIAL_GPS_IN  // else Serial is the GPS port, opened above
+    Serial.begin(115200);
+    Serial.println(F("Time warp, type new factor + Enter, 0 = as fast as possible"));
+  #endif
+  warpLastMillis = millis();
+#endif
+
+#ifdef FEATURE_SERIAL_FOOTPRINT
+  Serial.begin(115200);
+  Footprint();
+#endif
+
+#ifdef FEATURE_SERIAL_BENCHMARK_KERNELS
+  Serial.begin(115200);
+  BenchmarkKernels();
 #endif
 }
 
 ////////////////////////////////////// L O O P //////////////////////////////////////////////////////////////////
 
-void loop() {
-  readGPS();        // decode incoming GPS
-  GPSParse();       // GPS statuscode snippet from TinyGPSParse.ino
-  syncCheck();      // set time with interrupt (or without interrupt)
-  updateDisplay();  // select function for selected screen
-  checkEncoder();   // check and read rotary encoder + its button
+void GPSIngest() {
+  readGPS();   // decode incoming GPS
+  GPSParse();  // GPS statuscode snippet from TinyGPSParse.ino
+}
 
-  
-  #ifdef FEATURE_INTERRUPTTEST
-    digitalWrite(LED_BUILTIN, state);
+void DisplaySend() {
+  if (lcd.drain(LCD_SLICE_US)) DisplayShown();  // send some of the changed characters, the rest in the next passes of loop()
+  #ifdef FEATURE_LCD_I2C
+    LcdBusCheck();  // timeouts on the I2C bus, restores the display
   #endif
+}
+
+void Controls() {
+  checkEncoder();   // rotation sampled by EncoderSample() + button of rotary encoder
 
   // In support of old user interface with buttons:
 #ifdef FEATURE_BUTTONS  // separate buttons which may be in addition to rotary encoder
@@ -1128,6 +1292,48 @@ void loop() {
 #endif  // FEATURE_BUTTONS
 }
 
+// Tasks of loop(), highest priority first, see clock_tasks.h. Times in ms. With 9600 baud from the GPS, the 64 byte UART
+// receive buffer is full after 67 ms
+const char taskNameGPS[]      PROGMEM = "GPS";
+const char taskNameSync[]     PROGMEM = "PPS";
+const char taskNameEncoder[]  PROGMEM = "Rotary";
+const char taskNameDraw[]     PROGMEM = "Draw";
+const char taskNameSend[]     PROGMEM = "LCD";
+const char taskNameControls[] PROGMEM = "Menu";
+const char taskNameJobs[]     PROGMEM = "Jobs";
+#ifdef FEATURE_DIAGNOSTICS
+const char taskNameSerial[]   PROGMEM = "Serial";
+#endif
+
+const Task tasks[] PROGMEM = {
+  // run             period deadline flags
+  {GPSIngest,         0,     50,     TASK_URGENT, taskNameGPS},       // while a face is drawn, too
+  {syncCheck,         0,     100,    0,           taskNameSync},      // set time with interrupt (or without interrupt)
+  {EncoderSample,     0,     50,     TASK_URGENT, taskNameEncoder},   // while a face is drawn, too. Faces which don't yield take tens of ms
+  {updateDisplay,     0,     1000,   TASK_YIELDS, taskNameDraw},      // select function for selected screen
+  {DisplaySend,       0,     100,    TASK_YIELDS, taskNameSend},      // restoring the LCD waits with delay()
+  {Controls,          0,     100,    0,           taskNameControls},  // the setup menu runs from here
+  {JobsRun,           0,     0,      0,           taskNameJobs},      // slices of resumable computations (clock_jobs.h)
+#ifdef FEATURE_DIAGNOSTICS
+  {DiagnosticsSerial, 1000,  0,      0,           taskNameSerial},    // checks every second, prints once per minute
+#endif
+};
+
+void loop() {
+  #ifdef FEATURE_SERIAL_BENCHMARK
+    if (!benchmarkDone && gps.location.isValid()) BenchmarkScreens();  // once, as screens need a position
+  #endif
+  #ifdef FEATURE_SERIAL_GOLDEN
+    if (!goldenDone && gps.location.isValid()) GoldenFrames();  // once, as screens need a position
+  #endif
+
+  TaskRun(tasks, sizeof(tasks) / sizeof(tasks[0]));
+
+  #ifdef FEATURE_INTERRUPTTEST
+    digitalWrite(LED_BUILTIN, state);
+  #endif
+}
+
 ////////////////////////////////////// END LOOP //////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////////
 //
@@ -1143,17 +1349,8 @@ void LocalUTC(  // local time, UTC, locator, option: ISO week #
                 // 2 for Chemical element on last two lines (27.3.2023)
 ) {             //
 
-#ifndef FEATURE_DATE_PER_SECOND
   localTime = now() + utcOffset * 60;  // in seconds since 1970
 
-#else  // for stepping date quickly and check calender function
-  localTime = now() + utcOffset * 60 + dateIteration * SPEED_UP_FACTOR; // fake local time by stepping per day
-  dateIteration = dateIteration + 1;
-//  Serial.print(dateIteration); Serial.print(": ");
-//  Serial.println(local);
-#endif
-loadNativeCharacters(languageNumber);
-
 // ********* **********
 
   Hour = hour(localTime);
@@ -1161,7 +1358,7 @@ loadNativeCharacters(languageNumber);
   Seconds = second(localTime);
 
   lcd.setCursor(0, 0);  // top line *********
-  sprintf(textBuffer, "%02d%c%02d%c%02d", Hour, dateTimeFormat[dateFormat].hourSep, Minute, dateTimeFormat[dateFormat].minSep, Seconds);
+  FmtTime(textBuffer, Hour, Minute, Seconds);
   lcd.print(textBuffer);
   lcd.print(F("      "));
   // local date
@@ -1174,7 +1371,7 @@ loadNativeCharacters(languageNumber);
 
     // right-adjusted long day name:
     nativeDayLong(localTime);  // output in "today"
-    sprintf(todayFormatted, "%12s", today);
+    FmtText(todayFormatted, today, 12);
     lcd.setCursor(8, 0);
     lcd.print(todayFormatted);
 
@@ -1183,16 +1380,8 @@ loadNativeCharacters(languageNumber);
       // option added 3.9.2022 - ISO week # on second line
       GregorianDate a(month(localTime), day(localTime), year(localTime));
       IsoDate ISO(a);
-      if       (strcmp(languages[languageNumber], "nb ")==0) lcd.print(F("Uke "));
-      else if  (strcmp(languages[languageNumber], "da ")==0) lcd.print(F("Uge "));
-      else if  (strcmp(languages[languageNumber], "nn ")==0) lcd.print(F("Veke "));
-      else if  (strcmp(languages[languageNumber], "sv ")==0) lcd.print(F("Vecka "));
-      else if ((strcmp(languages[languageNumber], "is ")==0)||
-               (strcmp(languages[languageNumber], "non")==0)) lcd.print(F("Vika "));
-      else if  (strcmp(languages[languageNumber], "de ")==0) lcd.print(F("Woche "));
-      else if  (strcmp(languages[languageNumber], "fr ")==0) lcd.print(F("Sem. ")); // "Semaine" is too long
-      else if  (strcmp(languages[languageNumber], "es ")==0) lcd.print(F("Semana "));
-      else lcd.print(F("Week "));  // also Dutch
+      TextUtf8_P(textBuffer, myWeek[languageNumber]);
+      lcd.print(textBuffer);
 
       lcd.print(ISO.GetWeek());
       lcd.print(" ");  // added space 15.01.2023 - needed for 1-digit week numbers
@@ -1230,7 +1419,7 @@ loadNativeCharacters(languageNumber);
       lcd.print(F("                    "));
 
       lcd.setCursor(0, 3);
-      sprintf(textBuffer, "%02d%c%02d%c%02d UTC ", hour(now()), dateTimeFormat[dateFormat].hourSep, minute(now()), dateTimeFormat[dateFormat].minSep, second(now()));
+      FmtText(FmtTime(textBuffer, hour(now()), minute(now()), second(now())), " UTC ");
       lcd.print(textBuffer);
 
 #ifdef FEATURE_SERIAL_GPS
@@ -1259,24 +1448,23 @@ void UTCLocator(  // UTC, locator, # satellites
   //       secondGPS = second(now());
   // #endif
 
-  loadNativeCharacters(languageNumber);
 
   lcd.setCursor(0, 0);  // top line *********
   //  if (gps.time.isValid())
   if (mode==0)
   { 
-    sprintf(textBuffer, "%02d%c%02d%c%02d         UTC", hour(now()), dateTimeFormat[dateFormat].hourSep, minute(now()), dateTimeFormat[dateFormat].minSep, second(now()));
+    FmtText(FmtTime(textBuffer, hour(now()), minute(now()), second(now())), "         UTC");
     lcd.print(textBuffer);
   }
   else  // mode == 1
   {
-    sprintf(textBuffer, "%02d%c%02d%c%02d", hour(now()), dateTimeFormat[dateFormat].hourSep, minute(now()), dateTimeFormat[dateFormat].minSep, second(now()));
+    FmtTime(textBuffer, hour(now()), minute(now()), second(now()));
     lcd.print(textBuffer);
     #ifdef UTC_ENGLISH_DAY_NAME        // New 27.2.2024: English
-      sprintf(todayFormatted, "%12s", dayStr(weekdayGPS));   // print right-justified : fixed 09.10.2024
+      FmtText(todayFormatted, dayStr(weekdayGPS), 12);   // print right-justified : fixed 09.10.2024
     #else
       nativeDayLong(now());   // output in "today": local language
-      sprintf(todayFormatted, "%12s", today);   // print right-justified
+      FmtText(todayFormatted, today, 12);   // print right-justified
     #endif
     lcd.print(todayFormatted);
   }
@@ -1289,7 +1477,7 @@ void UTCLocator(  // UTC, locator, # satellites
       lcd.print(dayStr(weekdayGPS));
     #else
       nativeDayLong(now());   // output in "today"
-      sprintf(todayFormatted, "%-12s", today);   // print left-justified
+      FmtText(todayFormatted, today, -12);   // print left-justified
       lcd.print(todayFormatted);
     #endif
     
@@ -1333,7 +1521,6 @@ void LocalSun(  // local time, sun x 3
                 // 2 toggle between Civil+Nautical (= 1) and Noon and now display
 ) 
 {
-  loadNativeCharacters(languageNumber);
   loadArrowCharacters();
 
   //
@@ -1342,15 +1529,14 @@ void LocalSun(  // local time, sun x 3
   if (mode == 0) LcdShortDayDateTimeLocal(0, 2);  // line 0
   else LcdShortDayDateTimeLocal(0, 0);
 
+  if (!faceRecompute) return;  // rise/set times as they are, see REFRESH_SKY in FACE_LIST
 
-//  if (gps.location.isValid()) {
-//    if (minuteGPS != oldMinute) {
 #ifndef DEBUG_MANUAL_POSITION
-      latitude = gps.location.lat();
-      lon = gps.location.lng();
+  latitude = gps.location.lat();
+  lon = gps.location.lng();
 #else
-      latitude = latitude_manual;
-      lon = longitude_manual;
+  latitude = latitude_manual;
+  lon = longitude_manual;
 #endif
 
   if (mode == 0) {
@@ -1363,16 +1549,13 @@ void LocalSun(  // local time, sun x 3
     LcdSolarRiseSet(2, 'C', ScreenLocalSunSimpler);
     LcdSolarRiseSet(3, 'N', ScreenLocalSunSimpler);
   }
-  else if (mode==2) {    // toggle 
+  else if (mode==2) {    // toggle every 10 sec, LAYOUT_TOGGLE in FACE_LIST
     LcdSolarRiseSet(1, ' ', ScreenLocalSunSimpler);
 
     if (now() % 20 < 10) {
       LcdSolarRiseSet(2, 'C', ScreenLocalSunSimpler);
 
-      if (now()%20 == 0)                                       // blank out line first, in case not written during midsummer
-      {
-        lcd.setCursor(0,3); lcd.print(F("                  "));  
-      }
+      lcd.setCursor(0,3); lcd.print(F("                  "));  // blank out line first, in case not written during midsummer
       LcdSolarRiseSet(3, 'N', ScreenLocalSunSimpler);
       //lcd.setCursor(17, 3); lcd.print(" "); // remove deg symbol
     }
@@ -1381,10 +1564,7 @@ void LocalSun(  // local time, sun x 3
         lcd.setCursor(19, 2); lcd.print(" ");   // remove 'C'
       LcdSolarRiseSet(3, 'Z', ScreenLocalSunAzEl);  // az, el now
     }
-//   }
-// }
   }
-  oldMinute = minuteGPS;
 }
 
 
@@ -1401,12 +1581,11 @@ void LocalSunAzEl() {  // local time, sun x 3
   //
   // shows Actual (0 deg), Civil (-6 deg), and Nautical (-12 deg) sun rise/set
   //
-  loadNativeCharacters(languageNumber);
   loadArrowCharacters();
 
   LcdShortDayDateTimeLocal(0, 0);  // line 0
   if (gps.location.isValid()) {
-    if (minuteGPS != oldMinute) {
+    if (faceRecompute) {
 #ifndef DEBUG_MANUAL_POSITION
       latitude = gps.location.lat();
       lon = gps.location.lng();
@@ -1420,7 +1599,6 @@ void LocalSunAzEl() {  // local time, sun x 3
       LcdSolarRiseSet(3, 'Z', ScreenLocalSunAzEl);  //Current Az El info
     }
   }
-  oldMinute = minuteGPS;
 }
 
 /*****
@@ -1436,13 +1614,12 @@ void LocalSunMoon() {  // local time, sun, moon
   //
   // shows solar rise/set in a chosen definition (Actual, Civil, ...)
   //
-  loadNativeCharacters(languageNumber);
   loadArrowCharacters();
 
   LcdShortDayDateTimeLocal(0, 0);  // line 0, (was time offset 2) to the left
 
   if (gps.location.isValid()) {
-    if (minuteGPS != oldMinute) {
+    if (faceRecompute) {
 
 #ifndef DEBUG_MANUAL_POSITION
       latitude = gps.location.lat();
@@ -1525,7 +1702,6 @@ void LocalSunMoon() {  // local time, sun, moon
       lcd.write(DEGREE);
     }
   }
-  oldMinute = minuteGPS;
 }
 
 /*****
@@ -1541,13 +1717,12 @@ void LocalMoon() {  // local time, moon phase, elevation, next rise/set
 
   //  String textbuf;
   float percentage;
-  loadNativeCharacters(languageNumber);
   loadArrowCharacters();
 
   LcdShortDayDateTimeLocal(0, 0);  // line 0, (was 1 position left) to line up with next lines
 
   if (gps.location.isValid()) {
-    if (minuteGPS != oldMinute) {  // update display every minute
+    if (faceRecompute) {  // every minute, see FACE_LIST
 
       // days since last new moon
       float Phase, PercentPhase;
@@ -1648,8 +1823,6 @@ void LocalMoon() {  // local time, moon phase, elevation, next rise/set
         PrintFixedWidth(lcd, (int)round(Az), 3);
         lcd.write(DEGREE);
       } else lcd.print(F("  No Rise/Set       "));
-
-      oldMinute = minuteGPS;
     }
   }
 }
@@ -1665,22 +1838,87 @@ Return value: Displays on LCD
 Issues: follows UTC day/night - may get incorrect sorting of rise/set times if timezone is very different from UTC?
 *****/
 
-void MoonRiseSet(void) {
+/*****
+Purpose:
+Sets latitude, lon from GPS, or from DEBUG_MANUAL_POSITION, for the faces and the jobs which need the position
 
-  loadNativeCharacters(languageNumber); // added 09.10.2024
-  loadArrowCharacters();
+Argument List: none
 
-  if (gps.location.isValid()) {
+Return value: None
+*****/
 
+void PositionFromGPS() {
 #ifndef DEBUG_MANUAL_POSITION
-    latitude = gps.location.lat();
-    lon = gps.location.lng();
+  latitude = gps.location.lat();
+  lon = gps.location.lng();
 #else
-    latitude = latitude_manual;
-    lon = longitude_manual;
+  latitude = latitude_manual;
+  lon = longitude_manual;
 #endif
+}
+
+// Rise/set for this and the next two UTC days, computed in slices by a job (clock_jobs.h), once per day and position
+struct MoonRiseSetTimes {
+  short rise[3], set[3];  // packed time '100*hr + min'
+  double riseAz[3], setAz[3];
+};
 
-    if (minuteGPS != oldMinute) {
+MOONRISESETWORK moonRiseSetWork;
+MoonRiseSetTimes moonRiseSetNext;   // filled in by the job
+MoonRiseSetTimes moonRiseSetTimes;  // published
+
+boolean MoonRiseSetStep(uint16_t stage) {
+  byte day = stage / MOON_RISE_SET_SLICES;  // 0 = this UTC day, 1 = next, 2 = the day after
+  byte slice = stage % MOON_RISE_SET_SLICES;
+
+  if (slice == 0) {
+    moonRiseSetWork.day = trunc(now() / 86400.0);
+    moonRiseSetWork.zone = float(utcOffset) / 60.0 - 24.0 * day;
+    moonRiseSetWork.lat = latitude;
+    moonRiseSetWork.lon = lon;
+  }
+  if (!MoonRiseSetSlice(&moonRiseSetWork, slice, &moonRiseSetNext.rise[day], &moonRiseSetNext.riseAz[day],
+                        &moonRiseSetNext.set[day], &moonRiseSetNext.setAz[day])) return false;
+  if (day < 2) return false;
+
+  moonRiseSetTimes = moonRiseSetNext;
+  return true;
+}
+
+Job moonRiseSetJob = { MoonRiseSetStep };
+
+uint32_t MoonRiseSetKey() {  // UTC day, time zone, position
+  return JobKey(JobKey(JobKey(now() / 86400, utcOffset), round(100 * latitude)), round(100 * lon));
+}
+
+void MoonRiseSetPrefetch() {  // in FACE_LIST
+  if (!gps.location.isValid()) return;
+  PositionFromGPS();
+  JobReady(&moonRiseSetJob, MoonRiseSetKey());
+}
+
+void MoonRiseSet(void) {
+
+  loadArrowCharacters();
+
+  if (gps.location.isValid()) {
+
+    PositionFromGPS();
+
+    if (faceRecompute) {
+
+      static boolean placeholder = false;
+      if (!JobReady(&moonRiseSetJob, MoonRiseSetKey()) && !moonRiseSetJob.valid) {  // last result until the new one is done
+        lcd.setCursor(0, 0);
+        lcd.print(F("M ..."));
+        placeholder = true;
+        return;
+      }
+      if (placeholder) {
+        lcd.setCursor(2, 0);
+        lcd.print(F("   "));
+        placeholder = false;
+      }
 
       short pRise, pSet, pRise2, pSet2, packedTime;  // time in compact format '100*hr + min'
       double rAz, sAz, rAz2, sAz2;
@@ -1693,7 +1931,10 @@ void MoonRiseSet(void) {
 
       // ***** rise/set for this UTC day:
 
-      GetMoonRiseSetTimes(float(utcOffset) / 60.0, latitude, lon, &pRise, &rAz, &pSet, &sAz);
+      pRise = moonRiseSetTimes.rise[0];
+      rAz = moonRiseSetTimes.riseAz[0];
+      pSet = moonRiseSetTimes.set[0];
+      sAz = moonRiseSetTimes.setAz[0];
 
       lcd.setCursor(0, 0);  // top line
       lcd.print(F("M "));
@@ -1775,7 +2016,10 @@ void MoonRiseSet(void) {
 
       // ****** rise/set for next UTC day:
 
-      GetMoonRiseSetTimes(float(utcOffset) / 60.0 - 24.0, latitude, lon, &pRise2, &rAz2, &pSet2, &sAz2);
+      pRise2 = moonRiseSetTimes.rise[1];
+      rAz2 = moonRiseSetTimes.riseAz[1];
+      pSet2 = moonRiseSetTimes.set[1];
+      sAz2 = moonRiseSetTimes.setAz[1];
 
       // Rise and set times for moon:
 
@@ -1832,7 +2076,10 @@ void MoonRiseSet(void) {
       // **** if there is room add a line or two more
       // rise/set for next UTC day:
       {
-        GetMoonRiseSetTimes(float(utcOffset) / 60.0 - 48.0, latitude, lon, &pRise2, &rAz2, &pSet2, &sAz2);
+        pRise2 = moonRiseSetTimes.rise[2];
+        rAz2 = moonRiseSetTimes.riseAz[2];
+        pSet2 = moonRiseSetTimes.set[2];
+        sAz2 = moonRiseSetTimes.setAz[2];
 
         // Rise and set times for moon:
 
@@ -1897,7 +2144,6 @@ void MoonRiseSet(void) {
       lcd.print(F("  "));
     }
   }
-  oldMinute = minuteGPS;
 }
 
 // Menu item ///////////////////////////////////////////////////////////////////////////////////////////
@@ -1918,13 +2164,48 @@ void lcdTimeZone(byte zoneNumber)  // display time on LCD in desired time zone.
   local = tzLocal.toLocal(utc, &tcrLocal);
   Hour = hour(local);
   Minute = minute(local);
-  sprintf(textBuffer, "%02d%c%02d ", Hour, dateTimeFormat[dateFormat].hourSep, Minute);
+  FmtText(FmtTime(textBuffer, Hour, Minute), " ");
   lcd.print(textBuffer);
   lcd.print(tcrLocal->abbrev);
 }
 
+void TimeZonesLocal(uint8_t arg)  // time zone set for clock
+{
+  lcdTimeZone(timeZoneNumber);
+}
+
+void TimeZonesSeconds(uint8_t arg)
+{
+  Seconds = second(localTime);
+  textBuffer[0] = dateTimeFormat[dateFormat].minSep;
+  FmtInt(textBuffer + 1, Seconds, 2, '0');
+  lcd.print(textBuffer);
+}
+
+void TimeZonesUTC(uint8_t arg)
+{
+  FmtText(FmtTime(textBuffer, hour(now()), minute(now())), " UTC  ");
+  lcd.print(textBuffer);
+}
+
+void TimeZonesBlank(uint8_t arg)  // rest of menu number in lower right-hand corner, blanked by LayoutRender()
+{
+}
+
+// The time zones are user selectable: 16 e.g. China Standard Time, 17 Indian Standard Time, 3 US Eastern, 7 Pacific US
+const LayoutField timeZonesLayout[] PROGMEM = {
+  { 0, 0, 17, LAYOUT_MINUTE | LAYOUT_DATEFORMAT, TimeZonesLocal,   0},   // 1. line ********* always time zone set for clock
+  {17, 0,  3, LAYOUT_SECOND | LAYOUT_DATEFORMAT, TimeZonesSeconds, 0},   // end of line 1 shows seconds
+  { 0, 1, 11, LAYOUT_MINUTE | LAYOUT_DATEFORMAT, TimeZonesUTC,     0},   // 2. line  always UTC *********
+  { 0, 2, 10, LAYOUT_MINUTE | LAYOUT_DATEFORMAT, lcdTimeZone,     16},   // ******** 3. line
+  {10, 2, 10, LAYOUT_MINUTE | LAYOUT_DATEFORMAT, lcdTimeZone,     17},
+  { 0, 3, 10, LAYOUT_MINUTE | LAYOUT_DATEFORMAT, lcdTimeZone,      3},   //////// line 4
+  {10, 3,  9, LAYOUT_MINUTE | LAYOUT_DATEFORMAT, lcdTimeZone,      7},
+  {19, 3,  1, LAYOUT_MINUTE | LAYOUT_DATEFORMAT, TimeZonesBlank,   0}};  // after the previous one, which may be 10 long
+
 /*****
 Purpose: Display time in 6 time zones on LCD, 4 user selectable
+Each time zone is only computed and written when the minute changes, see timeZonesLayout[]
 
 Argument List: none
 
@@ -1935,37 +2216,7 @@ void TimeZones() {  // local time, UTC, + 4 more time zones (user selectable)
                     //  https://github.com/khoih-prog/Timezone_Generic
 
   // show local time in many locations
-
-  lcd.setCursor(0, 0);  // 1. line ********* always time zone set for clock
-  lcdTimeZone(timeZoneNumber);
-
-  lcd.setCursor(17, 0);  // end of line 1 shows seconds
-  Seconds = second(localTime);
-  sprintf(textBuffer, "%c%02d", dateTimeFormat[dateFormat].minSep, Seconds);
-  lcd.print(textBuffer);
-
-  lcd.setCursor(0, 1);  // 2. line  always UTC *********
-  sprintf(textBuffer, "%02d%c%02d UTC  ", hour(now()), dateTimeFormat[dateFormat].hourSep, minute(now()));
-  lcd.print(textBuffer);
-
-  // First user selectable (e.g. China Standard Time)
-  lcd.setCursor(0, 2);  // ******** 3. line
-  lcdTimeZone(16);
-
-  // Second user selectable (e.g. Indian Standard Time)
-  lcd.setCursor(10, 2);
-  lcdTimeZone(17);
-
-  // Third user selectable (e.g. US Eastern Time Zone)
-  lcd.setCursor(0, 3);  //////// line 4
-  lcdTimeZone(3);
-
-  // Fourth user selectable (e.g. Pacific US)
-  lcd.setCursor(10, 3);
-  lcdTimeZone(7);
-
-  lcd.setCursor(19, 3);
-  lcd.print(" ");  // blank out rest of menu number in lower right-hand corner
+  LayoutRender(LAYOUT(timeZonesLayout));
   oldMinute = minuteGPS;
 }
 
@@ -2018,31 +2269,25 @@ void Binary(byte mode) {  // binary local time
     lcd.setCursor(0, 0);
     lcd.print(F("BCD"));
 
-    lcd.setCursor(9, 0);
-    sprintf(textBuffer, " %1d  %1d  %1d", BinaryHour[2], BinaryMinute[2], BinarySeconds[2]);
-    lcd.print(textBuffer);
-    lcd.setCursor(19, 0);
-    lcd.print("8");
-
     //   lcd.setCursor(0,1); lcd.print("hh mm ss");
-    lcd.setCursor(9, 1);
-    sprintf(textBuffer, " %1d %1d%1d %1d%1d", BinaryHour[3], BinaryTensMinute[3], BinaryMinute[3], BinaryTensSeconds[3], BinarySeconds[3]);
-    lcd.print(textBuffer);
-    lcd.setCursor(19, 1);
-    lcd.print("4");
-
-    lcd.setCursor(9, 2);
-    sprintf(textBuffer, "%1d%1d %1d%1d %1d%1d", BinaryTensHour[4], BinaryHour[4], BinaryTensMinute[4], BinaryMinute[4], BinaryTensSeconds[4], BinarySeconds[4]);
-    lcd.print(textBuffer);
-    lcd.setCursor(19, 2);
-    lcd.print("2");
-
-
-    lcd.setCursor(9, 3);  //LSB
-    sprintf(textBuffer, "%1d%1d %1d%1d %1d%1d  ", BinaryTensHour[5], BinaryHour[5], BinaryTensMinute[5], BinaryMinute[5], BinaryTensSeconds[5], BinarySeconds[5]);
-    lcd.print(textBuffer);
-    lcd.setCursor(19, 3);
-    lcd.print("1");
+    for (byte bit = 2; bit <= 5; bit++)  // one line per weight: 8, 4, 2, 1 (LSB)
+    {
+      char *p = textBuffer;  // tens of hours have 2 bits, tens of minutes and seconds 3
+      *p++ = bit >= 4 ? '0' + BinaryTensHour[bit] : ' ';
+      p = FmtBits(p, BinaryHour, bit, bit);
+      *p++ = ' ';
+      *p++ = bit >= 3 ? '0' + BinaryTensMinute[bit] : ' ';
+      p = FmtBits(p, BinaryMinute, bit, bit);
+      *p++ = ' ';
+      *p++ = bit >= 3 ? '0' + BinaryTensSeconds[bit] : ' ';
+      p = FmtBits(p, BinarySeconds, bit, bit);
+      if (bit == 5) FmtText(p, "  ");  // last line also blanks columns 17-18
+
+      lcd.setCursor(9, bit - 2);
+      lcd.print(textBuffer);
+      lcd.setCursor(19, bit - 2);
+      lcd.print(8 >> (bit - 2));
+    }
   } else if (mode == 1) {
     //// horizontal BCD digits:
 
@@ -2050,21 +2295,21 @@ void Binary(byte mode) {  // binary local time
     lcd.print(F("BCD"));
 
     lcd.setCursor(9, 1);
-    sprintf(textBuffer, "  %1d%1d ", BinaryTensHour[4], BinaryTensHour[5]);
+    FmtText(FmtBits(FmtText(textBuffer, "  "), BinaryTensHour, 4, 5), " ");
     lcd.print(textBuffer);
-    sprintf(textBuffer, "%1d%1d%1d%1d H", BinaryHour[2], BinaryHour[3], BinaryHour[4], BinaryHour[5]);
+    FmtText(FmtBits(textBuffer, BinaryHour, 2, 5), " H");
     lcd.print(textBuffer);
 
     lcd.setCursor(9, 2);
-    sprintf(textBuffer, " %1d%1d%1d ", BinaryTensMinute[3], BinaryTensMinute[4], BinaryTensMinute[5]);
+    FmtText(FmtBits(FmtText(textBuffer, " "), BinaryTensMinute, 3, 5), " ");
     lcd.print(textBuffer);
-    sprintf(textBuffer, "%1d%1d%1d%1d M", BinaryMinute[2], BinaryMinute[3], BinaryMinute[4], BinaryMinute[5]);
+    FmtText(FmtBits(textBuffer, BinaryMinute, 2, 5), " M");
     lcd.print(textBuffer);
 
     lcd.setCursor(9, 3);
-    sprintf(textBuffer, " %1d%1d%1d ", BinaryTensSeconds[3], BinaryTensSeconds[4], BinaryTensSeconds[5]);
+    FmtText(FmtBits(FmtText(textBuffer, " "), BinaryTensSeconds, 3, 5), " ");
     lcd.print(textBuffer);
-    sprintf(textBuffer, "%1d%1d%1d%1d S", BinarySeconds[2], BinarySeconds[3], BinarySeconds[4], BinarySeconds[5]);
+    FmtText(FmtBits(textBuffer, BinarySeconds, 2, 5), " S");
     lcd.print(textBuffer);
 
 
@@ -2087,15 +2332,15 @@ void Binary(byte mode) {  // binary local time
     DecToBinary(Seconds, BinarySeconds);
 
     lcd.setCursor(13, 1);
-    sprintf(textBuffer, "%1d%1d%1d%1d%1d H", BinaryHour[1], BinaryHour[2], BinaryHour[3], BinaryHour[4], BinaryHour[5]);
+    FmtText(FmtBits(textBuffer, BinaryHour, 1, 5), " H");
     lcd.print(textBuffer);
 
     lcd.setCursor(12, 2);
-    sprintf(textBuffer, "%1d%1d%1d%1d%1d%1d M", BinaryMinute[0], BinaryMinute[1], BinaryMinute[2], BinaryMinute[3], BinaryMinute[4], BinaryMinute[5]);
+    FmtText(FmtBits(textBuffer, BinaryMinute, 0, 5), " M");
     lcd.print(textBuffer);
 
     lcd.setCursor(12, 3);
-    sprintf(textBuffer, "%1d%1d%1d%1d%1d%1d S", BinarySeconds[0], BinarySeconds[1], BinarySeconds[2], BinarySeconds[3], BinarySeconds[4], BinarySeconds[5]);
+    FmtText(FmtBits(textBuffer, BinarySeconds, 0, 5), " S");
     lcd.print(textBuffer);
 
     lcd.setCursor(0, 0);
@@ -2115,9 +2360,9 @@ void Binary(byte mode) {  // binary local time
 
   if (Seconds < secondsClockHelp)  // show time in normal numbers
   {
-    sprintf(textBuffer, "%02d%c%02d%c%02d", Hour, dateTimeFormat[dateFormat].hourSep, Minute, dateTimeFormat[dateFormat].minSep, Seconds);
+    FmtTime(textBuffer, Hour, Minute, Seconds);
   } else {
-    sprintf(textBuffer, "        ");
+    FmtText(textBuffer, "        ");
   }
   lcd.setCursor(0, 3);  // last line *********
   lcd.print(textBuffer);
@@ -2201,7 +2446,7 @@ void Bar(void) {
   lcd.setCursor(9, 3);
   if (Seconds < secondsClockHelp)  // show time in normal numbers
   {
-    sprintf(textBuffer, "%02d%c%02d%c%02d", Hour % 12, dateTimeFormat[dateFormat].hourSep, Minute, dateTimeFormat[dateFormat].minSep, Seconds);
+    FmtTime(textBuffer, Hour % 12, Minute, Seconds);
     lcd.print(textBuffer);
   } else {
     lcd.print(F("         "));
@@ -2458,15 +2703,17 @@ void InternalTime() {  // UTC, Unix time, J2000, etc
     float jd1970 = now() / 86400.0;  // cdn(now()); // now/86400, i.e. no of days since 1970 [No leap seconds]
     float j2000 = jd1970 - 10957.5;  // 1- line
     lcd.print(F("j2k "));
-    lcd.print(j2000);
+    FmtFixed(textBuffer, j2000, 0, 2);
+    lcd.print(textBuffer);
 
     lcd.setCursor(12, 0);
-    sprintf(textBuffer, "%02d%c%02d%c%02d UTC ", hour(now()), dateTimeFormat[dateFormat].hourSep, minute(now()), dateTimeFormat[dateFormat].minSep, second(now()));
+    FmtText(FmtTime(textBuffer, hour(now()), minute(now()), second(now())), " UTC ");
     lcd.print(textBuffer);
 
     lcd.setCursor(0, 2);
     lcd.print(F("jd1970 "));
-    lcd.print(jd1970,3);
+    FmtFixed(textBuffer, jd1970, 0, 3);
+    lcd.print(textBuffer);
    
     lcd.setCursor(0, 1);
     Seconds = second(now());
@@ -2480,7 +2727,8 @@ void InternalTime() {  // UTC, Unix time, J2000, etc
     jd = get_julian_date(Day, Month, Year, Hour, Minute, Seconds);  // local - since year 4713 BC
     
     lcd.print(F("jd   "));
-    lcd.print(jd,1);lcd.print("+"); lcd.print(jd_frac,3);  // more accurate
+    FmtFixed(FmtText(FmtFixed(textBuffer, jd, 0, 1), "+"), jd_frac, 0, 3);
+    lcd.print(textBuffer);  // more accurate
     // float jdd = jd + jd_frac; lcd.print(jdd);  // loses accuracy relative to previous line
    
     lcd.setCursor(0, 3);
@@ -2522,6 +2770,228 @@ void CodeStatus(void) {
   lcd.print(F("   "));
 }
 
+#ifdef FEATURE_PROFILER
+/*****
+Purpose: Menu item
+Execution time per screen, measured in updateDisplay(): mean, p99, max in ms
+Screens sorted by decreasing p99, 3 per page. Screen numbers as in clock_defines.h
+
+Argument List: None
+
+Return value: Displays on LCD
+*****/
+
+void Profiler() {
+  int screens[3];
+  int measured = 0;
+  for (int i = 0; i < noOfScreens; i++)
+    if (profile[i].count > 0) measured += 1;
+
+  int noOfPages = max((measured + 2) / 3, 1);
+  int page = (now() / 5) % noOfPages;  // new page every 5 sec
+  byte found = ProfilerRanking(3 * page, screens, 3);
+
+  lcd.setCursor(0, 0);
+  lcd.print(F("#   mean   p99   max"));
+
+  for (byte line = 0; line < 3; line++)
+  {
+    lcd.setCursor(0, line + 1);
+    if (line < found)
+    {
+      int screen = screens[line];
+      PrintFixedWidth(lcd, screen, 2);
+      LcdMilliseconds(profile[screen].sumUs / max(profile[screen].count, uint16_t(1)));
+      LcdMilliseconds(ProfilerP99(screen));
+      LcdMilliseconds(profile[screen].maxUs);
+    }
+    else lcd.print(F("                    "));
+  }
+}
+#endif
+
+#ifdef FEATURE_DIAGNOSTICS
+/*****
+Purpose: Menu item
+Shows if loop() is too slow for reading GPS data:
+  max time between readGPS() calls (ms) + screen shown at the time
+  no of times this was long enough to fill the UART receive buffer + no of times it was found full
+  GPS checksum errors
+  no of $GPGSV sentences seen and expected
+A new page every 5 sec. Second page:
+  smallest free stack since startup (stack painting), and free stack now
+  scratch arena: peak use of size, and no of times it was full, largest LCD queue (changed characters in a frame)
+Third page: pulse-to-glass latency (ms) from 1PPS to last character sent: last, no of pulses, mean, min, max
+Fourth page: faces which recomputed, and which only refreshed the time (cadence, see CadenceBegin()), % avoided
+Fifth page, with I2C display: bus timeouts, failed writes, and no of times the display was restored
+Counts are limited to the width of the field
+
+Argument List: None
+
+Return value: Displays on LCD
+*****/
+
+#ifdef FEATURE_LCD_I2C
+  #define DIAGNOSTICS_PAGES 5
+#else
+  #define DIAGNOSTICS_PAGES 4
+#endif
+
+void Diagnostics() {
+  byte page = (now() / 5) % DIAGNOSTICS_PAGES;  // a new page every 5 sec
+
+#ifdef FEATURE_LCD_I2C
+  if (page == 4) {
+    lcd.setCursor(0, 0);
+    lcd.print(F("LCD I2C bus         "));
+
+    lcd.setCursor(0, 1);
+    lcd.print(F("Timeouts    "));
+    LcdCount(i2cTimeouts, 8);
+
+    lcd.setCursor(0, 2);
+    lcd.print(F("Write errors"));
+    LcdCount(lcd.writeErrors, 8);
+
+    lcd.setCursor(0, 3);
+    lcd.print(F("Restored    "));
+    LcdCount(i2cRecoveries, 8);
+    return;
+  }
+#endif
+
+  if (page == 3) {
+    uint32_t faces = cadenceRecomputed + cadenceAvoided;
+    lcd.setCursor(0, 0);
+    lcd.print(F("Face recompute      "));
+
+    lcd.setCursor(0, 1);
+    lcd.print(F("Done        "));
+    LcdCount(cadenceRecomputed, 8);
+
+    lcd.setCursor(0, 2);
+    lcd.print(F("Avoided     "));
+    LcdCount(cadenceAvoided, 8);
+
+    lcd.setCursor(0, 3);
+    lcd.print(F("Avoided %        "));
+    LcdCount(faces ? uint32_t(100.0 * cadenceAvoided / faces + 0.5) : 0, 3);
+    return;
+  }
+
+  if (page == 2) {
+    lcd.setCursor(0, 0);
+#ifdef DISPLAY_ON_PPS
+    lcd.print(F("PPS to LCD ms  ahead"));
+#else
+    lcd.print(F("PPS to LCD ms       "));
+#endif
+
+    lcd.setCursor(0, 1);
+    lcd.print(F("Last"));
+    LcdMilliseconds(latencyLast);
+    lcd.print(F(" n"));
+    LcdCount(latencyCount, 8);
+
+    lcd.setCursor(0, 2);
+    lcd.print(F("Mean"));
+    LcdMilliseconds(latencyMean);
+    lcd.print(F("          "));
+
+    lcd.setCursor(0, 3);
+    lcd.print(F("Min"));
+    LcdMilliseconds(latencyCount ? latencyMin : 0);
+    lcd.print(F(" Max"));
+    LcdMilliseconds(latencyMax);
+    lcd.print(F(" "));
+    return;
+  }
+
+  if (page == 1) {
+    uint8_t marker;  // on the stack, i.e. current end of stack
+    lcd.setCursor(0, 0);
+    lcd.print(F("Stack free min"));
+    LcdCount(StackFree(), 6);
+
+    lcd.setCursor(0, 1);
+    lcd.print(F("Stack free now"));
+    LcdCount(&marker - HEAP_END, 6);
+
+    lcd.setCursor(0, 2);
+    lcd.print(F("Scratch "));
+    LcdCount(scratchPeak, 5);
+    lcd.print(F(" of"));
+    LcdCount(SCRATCH_SIZE, 4);
+
+    lcd.setCursor(0, 3);
+    lcd.print(F("Scr full"));
+    LcdCount(scratchOverflows, 4);
+    lcd.print(F(" LCDq"));
+    LcdCount(lcd.queuePeak, 3);
+    return;
+  }
+
+  lcd.setCursor(0, 0);
+  lcd.print(F("Max gap"));
+  LcdMilliseconds(maxLoopGap);
+  lcd.print(F("ms #"));
+  PrintFixedWidth(lcd, maxLoopGapScreen, 2);
+  lcd.print(F(" "));  // clears last position of 2nd page
+
+  lcd.setCursor(0, 1);
+  lcd.print(F("Slow"));
+  LcdCount(longLoopGaps, 5);
+  lcd.print(F(" Full"));
+  LcdCount(uartOverflows, 6);
+
+  lcd.setCursor(0, 2);
+  lcd.print(F("Checksum err"));
+  LcdCount(gps.failedChecksum(), 8);
+
+  lcd.setCursor(0, 3);
+  lcd.print(F("GSV"));
+  LcdCount(gpgsvSeen, 7);
+  lcd.print(F(" of"));
+  LcdCount(gpgsvExpected, 7);
+}
+#endif
+
+#ifdef FEATURE_DIAGNOSTICS
+/*****
+Purpose: Menu item
+Tasks of loop() (clock_tasks.h) in order of priority, 3 per page, a new page every 5 sec:
+  name, mean and max execution time in ms, no of deadline misses (limited to 99)
+
+Argument List: None
+
+Return value: Displays on LCD
+*****/
+
+void Tasks() {
+  byte noOfPages = max((taskCount + 2) / 3, 1);
+  byte page = (now() / 5) % noOfPages;  // a new page every 5 sec
+
+  lcd.setCursor(0, 0);
+  lcd.print(F("Task    mean   max !"));
+
+  for (byte line = 0; line < 3; line++)
+  {
+    byte i = 3 * page + line;
+    lcd.setCursor(0, line + 1);
+    if (i < taskCount)
+    {
+      const char *name = (const char *)pgm_read_ptr(&taskTable[i].name);
+      lcd.print((const __FlashStringHelper *)name);
+      for (byte j = strlen_P(name); j < 6; j++) lcd.print(" ");
+      LcdMilliseconds(taskStats[i].sumUs / max(taskStats[i].runs, uint16_t(1)));
+      LcdMilliseconds(taskStats[i].maxUs);
+      LcdCount(taskStats[i].misses, 2);
+    }
+    else lcd.print(F("                    "));
+  }
+}
+#endif
+
 /*****
 Purpose: Menu item
 Gives UTC time, locator, latitude/longitude, altitude and no of satellites
@@ -2532,7 +3002,6 @@ Return value: Displays on LCD
 *****/
 
 void UTCPosition() {  // position, altitude, locator, # satellites
-  String textBuffer;
 
   LcdUTCTimeLocator(0, 1);  // top line ********* start 1 position right - in order to line up with latitude/longitude
   // UTC date
@@ -2558,7 +3027,7 @@ void UTCPosition() {  // position, altitude, locator, # satellites
       //  decimal degrees
       lcd.setCursor(1, 2);
       if (abs(latitude) < 10) lcd.print(" ");
-      textBuffer = String(abs(latitude), 4);
+      FmtFixed(textBuffer, abs(latitude), 0, 4);
       lcd.print(textBuffer);
       lcd.write(DEGREE);
       if (latitude < 0) lcd.print(F(" S   "));
@@ -2570,7 +3039,8 @@ void UTCPosition() {  // position, altitude, locator, # satellites
       //lcd.print(textBuffer);
       if (abs(lon) < 100) lcd.print(" ");
       if (abs(lon) < 10) lcd.print(" ");
-      lcd.print(abs(lon), 4);
+      FmtFixed(textBuffer, abs(lon), 0, 4);
+      lcd.print(textBuffer);
       lcd.write(DEGREE);
       if (lon < 0) lcd.print(F(" W    "));
       else lcd.print(F(" E    "));
@@ -2625,7 +3095,7 @@ void UTCPosition() {  // position, altitude, locator, # satellites
       lcd.write(DEGREE);
       mins = abs(60 * (latitude - (int)latitude));
       if (mins < 10) lcd.print('0');
-      textBuffer = String(abs(mins), 2);
+      FmtFixed(textBuffer, abs(mins), 0, 2);
       lcd.print(textBuffer);
       if (latitude < 0) lcd.print(F("' S "));
       else lcd.print(F("' N "));
@@ -2637,7 +3107,7 @@ void UTCPosition() {  // position, altitude, locator, # satellites
       lcd.write(DEGREE);
       mins = abs(60 * (lon - (int)lon));
       if (mins < 10) lcd.print('0');
-      textBuffer = String(abs(mins), 2);  // double abs() to avoid negative number for x.00 degrees
+      FmtFixed(textBuffer, abs(mins), 0, 2);  // double abs() to avoid negative number for x.00 degrees
       lcd.print(textBuffer);
       if (lon < 0) lcd.print(F("' W  "));
       else lcd.print(F("' E  "));
@@ -2743,9 +3213,9 @@ void WSPRsequence() {  // UTC, + WSPR band/frequency for coordinated WSPR
 
   int ii;
   int isec;
-  // 10.4.2023: changed from char to int and float storage to save RAM:
-  int band[11] = { 160, 80, 60, 40, 30, 20, 17, 15, 12, 10 };
-  float qrg[11] = { 1838.100, 3570.100, 5366.200, 7040.100, 10140.200, 14097.100, 18106.100, 21096.100, 24926.100, 28126.100 };
+  // 10.4.2023: changed from char to int and float storage to save RAM, now in flash:
+  static const int band[10] PROGMEM = { 160, 80, 60, 40, 30, 20, 17, 15, 12, 10 };
+  static const float qrg[10] PROGMEM = { 1838.100, 3570.100, 5366.200, 7040.100, 10140.200, 14097.100, 18106.100, 21096.100, 24926.100, 28126.100 };
 
   loadGapLessCharacters7A();   // load LCD characters if not loaded
 
@@ -2773,9 +3243,10 @@ void WSPRsequence() {  // UTC, + WSPR band/frequency for coordinated WSPR
     //Serial.print("minuteGPS "); Serial.println(minuteGPS);
     //Serial.print("isec      "); Serial.println(isec);
     lcd.setCursor(0, 2);
-    lcd.print(band[ii]);
+    lcd.print(int(pgm_read_word(&band[ii])));
     lcd.print(F(" m "));
-    lcd.print(qrg[ii], 1);
+    FmtFixed(textBuffer, pgm_read_float(&qrg[ii]), 0, 1);
+    lcd.print(textBuffer);
     lcd.print(F(" kHz  "));
     lcd.setCursor(17, 2);
     PrintFixedWidth(lcd, isec, 3);  // seconds into transmission
@@ -2811,14 +3282,14 @@ void HexOctalClock(byte val) {
   if (val == 0)  // Hex
   {
     lcd.setCursor(7, 0);  // one line up 18.6.2023
-    sprintf(textBuffer, "%02X%c%02X%c%02X", Hour, dateTimeFormat[dateFormat].hourSep, Minute, dateTimeFormat[dateFormat].minSep, Seconds);
+    FmtTime(textBuffer, Hour, Minute, Seconds, 16);
     lcd.print(textBuffer);
     lcd.setCursor(17, 3);
     lcd.print(F("   "));
   } else if (val == 1)  // Oct
   {
     lcd.setCursor(7, 0);  // one line up 18.6.2023
-    sprintf(textBuffer, "%02o%c%02o%c%02o", Hour, dateTimeFormat[dateFormat].hourSep, Minute, dateTimeFormat[dateFormat].minSep, Seconds);
+    FmtTime(textBuffer, Hour, Minute, Seconds, 8);
     lcd.print(textBuffer);
     lcd.setCursor(17, 3);
     lcd.print(F("   "));
@@ -2830,27 +3301,27 @@ void HexOctalClock(byte val) {
     DecToBinary(Seconds, BinarySeconds);
 
     lcd.setCursor(0, 0);
-    sprintf(textBuffer, "%1d%1d%1d%1d%1d", BinaryHour[1], BinaryHour[2], BinaryHour[3], BinaryHour[4], BinaryHour[5]);
+    FmtBits(textBuffer, BinaryHour, 1, 5);
     lcd.print(textBuffer);
     lcd.print(dateTimeFormat[dateFormat].hourSep);
 
-    sprintf(textBuffer, "%1d%1d%1d%1d%1d%1d", BinaryMinute[0], BinaryMinute[1], BinaryMinute[2], BinaryMinute[3], BinaryMinute[4], BinaryMinute[5]);
+    FmtBits(textBuffer, BinaryMinute, 0, 5);
     lcd.print(textBuffer);
     lcd.print(dateTimeFormat[dateFormat].minSep);
 
-    sprintf(textBuffer, "%1d%1d%1d%1d%1d%1dB", BinarySeconds[0], BinarySeconds[1], BinarySeconds[2], BinarySeconds[3], BinarySeconds[4], BinarySeconds[5]);
+    FmtText(FmtBits(textBuffer, BinarySeconds, 0, 5), "B");
     lcd.print(textBuffer);
 
     lcd.setCursor(19, 1);
     lcd.print("O");
     lcd.setCursor(7, 1);
-    sprintf(textBuffer, "%02o%c%02o%c%02o", Hour, dateTimeFormat[dateFormat].hourSep, Minute, dateTimeFormat[dateFormat].minSep, Seconds);  // octal
+    FmtTime(textBuffer, Hour, Minute, Seconds, 8);  // octal
     lcd.print(textBuffer);
 
     lcd.setCursor(18, 3);
     lcd.print(F(" H"));
     lcd.setCursor(7, 3);
-    sprintf(textBuffer, "%02X%c%02X%c%02X", Hour, dateTimeFormat[dateFormat].hourSep, Minute, dateTimeFormat[dateFormat].minSep, Seconds);  // hex
+    FmtTime(textBuffer, Hour, Minute, Seconds, 16);  // hex
     lcd.print(textBuffer);
   }
 
@@ -2866,7 +3337,7 @@ void HexOctalClock(byte val) {
       lcd.print(F("  "));  // clear number in lower left corner
     }
     lcd.setCursor(7, 2);
-    sprintf(textBuffer, "%02d%c%02d%c%02d", Hour, dateTimeFormat[dateFormat].hourSep, Minute, dateTimeFormat[dateFormat].minSep, Seconds);
+    FmtTime(textBuffer, Hour, Minute, Seconds);
     lcd.print(textBuffer);
   } else {
     lcd.setCursor(0, 2);
@@ -2903,7 +3374,7 @@ void EasterDates(int yr) {
   lcd.setCursor(0, 0);
   lcd.print(F("Easter  Greg. Julian"));
 
-  if (minuteGPS != oldMinute) {
+  if (faceRecompute) {
 
     for (int yer = yr; yer < yr + 3; yer++) {
       lcd.setCursor(2, ii);
@@ -2927,7 +3398,6 @@ void EasterDates(int yr) {
       ii++;
     }
   }
-  oldMinute = minuteGPS;
 }
 
 
@@ -3113,13 +3583,43 @@ Return value: Displays on LCD
 
 *****/
 
+// Eclipses of this and the next two years, found in slices by a job (clock_jobs.h), one full moon per step
+
+#define ECLIPSES_PER_YEAR 6  // incl. the terminating 0, at most 5 eclipses in the 14 full moons from a year
+
+EclipseYearData eclipseYearData;
+int eclipseCount;
+int eclipseDates[3][ECLIPSES_PER_YEAR];  // packed date = 100*month + day, 0 = no more
+int eclipseYears[3][ECLIPSES_PER_YEAR];
+
+boolean LunarEclipseStep(uint16_t stage) {
+  byte year = stage / (ECLIPSE_FULL_MOONS + 1);  // from yearGPS
+  byte moon = stage % (ECLIPSE_FULL_MOONS + 1);  // 0 = constants for the year
+
+  if (moon == 0) {
+    MoonEclipseYear(yearGPS + year, &eclipseYearData);
+    eclipseCount = 0;
+  } else if (eclipseCount < ECLIPSES_PER_YEAR - 1) {
+    eclipseCount += MoonEclipseFullMoon(&eclipseYearData, 2 * moon - 1, &eclipseDates[year][eclipseCount],
+                                        &eclipseYears[year][eclipseCount]);
+  }
+  eclipseDates[year][eclipseCount] = 0;
+  return (year == 2) && (moon == ECLIPSE_FULL_MOONS);
+}
+
+Job lunarEclipseJob = { LunarEclipseStep };
+
+void LunarEclipsePrefetch() {  // in FACE_LIST
+  JobReady(&lunarEclipseJob, yearGPS);
+}
+
 void LunarEclipse() {
-  int pDate[10];  // max 5 per day: packed date = 100*month + day, i.e. 1209 = 9 December
-  int eYear[10];
+  int *pDate;  // packed date = 100*month + day, i.e. 1209 = 9 December
+  int *eYear;
   int pday, pmonth, yy;
   int i;
 
-  if (minuteGPS != oldMinute) {
+  if (faceRecompute) {
 
 
     lcd.setCursor(0, 0);
@@ -3129,14 +3629,19 @@ void LunarEclipse() {
     // Test: try 2028 with 3 eclipses, see https://www.timeanddate.com/eclipse/list-lunar.html
     yy = yearGPS;  //
 
+    if (!JobReady(&lunarEclipseJob, yy)) {  // overwritten by the year when done
+      lcd.setCursor(2, 1);
+      lcd.print(F("..."));
+      return;
+    }
+
 #ifdef FEATURE_SERIAL_LUNARECLIPSE
     Serial.print((int)yy);
     Serial.println(F(" ****************"));
 #endif
 
-    for (i = 0; i < 10; i++) pDate[i] = 0;
-
-    MoonEclipse(yy, pDate, eYear);
+    pDate = eclipseDates[0];
+    eYear = eclipseYears[0];
     int lineNo = 1;
     lcd.setCursor(2, lineNo);
     lcd.print(yy);
@@ -3158,9 +3663,9 @@ void LunarEclipse() {
       }
     }
 
-    for (i = 0; i < 10; i++) pDate[i] = 0;
     yy = yy + 1;
-    MoonEclipse(yy, pDate, eYear);
+    pDate = eclipseDates[1];
+    eYear = eclipseYears[1];
 
     //pDate[2] = 729; //pDate[3] = 1209; pDate[4] = 101; // artificial data  for testing
 
@@ -3185,10 +3690,9 @@ void LunarEclipse() {
     }
 
     if (lineNo < 3) {
-      for (i = 0; i < 10; i++) pDate[i] = 0;
-
       yy = yy + 1;
-      MoonEclipse(yy, pDate, eYear);
+      pDate = eclipseDates[2];
+      eYear = eclipseYears[2];
 
       lineNo = lineNo + 1;
       lcd.setCursor(2, lineNo);
@@ -3212,7 +3716,6 @@ void LunarEclipse() {
       lcd.setCursor(18, 3);
       lcd.print(F("  "));  // erase lower right-hand corner if not already done
     }
-    oldMinute = Minute;
   }
 }
 
@@ -3269,7 +3772,7 @@ void Roman() {
   if (Seconds < secondsClockHelp)  // show time in normal numbers
   {
     lcd.setCursor(0, 3);
-    sprintf(textBuffer, "%02d%c%02d%c%02d", Hour, dateTimeFormat[dateFormat].hourSep, Minute, dateTimeFormat[dateFormat].minSep, Seconds);
+    FmtTime(textBuffer, Hour, Minute, Seconds);
     lcd.print(textBuffer);
   } else {
     lcd.setCursor(0, 3);
@@ -3317,11 +3820,10 @@ void Sidereal()  // LST - Local Sidereal Time - updated 26.12.2024
 
   
   // display results:
-  //loadNativeCharacters(languageNumber);
   //LcdShortDayDateTimeLocal(0, 0);  // line 0 local time
 
   lcd.setCursor(0, 0);
-  sprintf(textBuffer, "UTC         %02d%c%02d%c%02d", hour(now()), dateTimeFormat[dateFormat].hourSep, minute(now()), dateTimeFormat[dateFormat].minSep, second(now()));
+  FmtTime(FmtText(textBuffer, "UTC         "), hour(now()), minute(now()), second(now()));
   lcd.print(textBuffer);
 
   // put this last display line second in code - better for Metro - otherwise "Si" is printed again on line 1 and "dereal" again on line 2
@@ -3335,8 +3837,7 @@ void Sidereal()  // LST - Local Sidereal Time - updated 26.12.2024
   // local time on line 1
   localTime = now() + utcOffset * 60;
   lcd.setCursor(4,1);
-  sprintf(textBuffer, "        %02d%c%02d%c%02d", hour(localTime), dateTimeFormat[dateFormat].hourSep, minute(localTime), 
-          dateTimeFormat[dateFormat].minSep, second(localTime));
+  FmtTime(FmtText(textBuffer, "        "), hour(localTime), minute(localTime), second(localTime));
   lcd.print(textBuffer);
 
   lcd.setCursor(0, 2);
@@ -3368,9 +3869,9 @@ void Sidereal()  // LST - Local Sidereal Time - updated 26.12.2024
   Hour = hour(solar);
   Minute = minute(solar);
   // Seconds = second(solar);
-  // sprintf(textBuffer, " %02d%c%02d%c%02d", Hour, dateTimeFormat[dateFormat].hourSep, Minute, dateTimeFormat[dateFormat].minSep, Seconds);
+  // FmtTime(FmtText(textBuffer, " "), Hour, Minute, Seconds);
   // drop seconds:
-  sprintf(textBuffer, " %02d%c%02d%   ", Hour, dateTimeFormat[dateFormat].hourSep, Minute);
+  FmtText(FmtTime(FmtText(textBuffer, " "), Hour, Minute), "   ");
   lcd.print(textBuffer);
 
 // must for some reason be last for Metro
@@ -3489,7 +3990,7 @@ void Morse()  // time in Morse code on LCD
   if (Seconds < secondsClockHelp)  // show time in normal numbers
   {
     lcd.setCursor(0, 3);
-    sprintf(textBuffer, "%02d%c%02d%c%02d", Hour, dateTimeFormat[dateFormat].hourSep, Minute, dateTimeFormat[dateFormat].minSep, Seconds);
+    FmtTime(textBuffer, Hour, Minute, Seconds);
     lcd.print(textBuffer);
   } else {
     lcd.setCursor(0, 3);
@@ -3615,8 +4116,8 @@ void DemoClock(byte inDemo  // 0 or 1
     lcd.setCursor(0, 1);
     lcd.print(F("Multi Face GPS Clock"));
 
-    lcd.setCursor(14,2);
-    sprintf(textBuffer, "%6s",demoStepTypeText[demoStepType]);   // print right-justified -> garbish
+    lcd.setCursor(13,2);
+    FmtText(textBuffer, demoStepTypeText[demoStepType], 7);   // print right-justified
     lcd.print(textBuffer);
     
     lcd.setCursor(0, 3);
@@ -3639,12 +4140,102 @@ Return value: none
 void WordClock() {
   if (strcmp(languages[languageNumber], "nb ")==0 || strcmp(languages[languageNumber], "nn ")==0) 
   {
-    loadAring();  // Å for Norwegian 
     WordClockNorwegian();
   }
   else WordClockEnglish();
 }
 
+// Planet positions, computed by a job (clock_jobs.h) for each of the two faces, a part of get_object_position() per
+// step, once per minute
+
+struct PlanetData {
+  float altitude, azimuth, phase, magnitude;
+};
+
+struct PlanetJob {
+  Job job;
+  const byte *objects;    // for get_object_position()
+  byte count;
+  float earth[4];         // x_earth, y_earth, z_earth, dist_earth_to_sun: get_object_position() for the planets needs them
+  float jd, jdFrac;
+  object_position_work work;  // between the parts of get_object_position_part()
+  PlanetData planets[3];  // each one replaced when found, all valid when job.valid
+};
+
+const byte planetsOuter[] = { 3, 4, 5 };  // Mars, Jupiter, Saturn
+const byte planetsInner[] = { 0, 1 };     // Mercury, Venus
+
+boolean PlanetStepOuter(uint16_t stage);
+boolean PlanetStepInner(uint16_t stage);
+
+PlanetJob planetJobs[2] = {  // index = inner
+  { { PlanetStepOuter }, planetsOuter, sizeof(planetsOuter) },
+  { { PlanetStepInner }, planetsInner, sizeof(planetsInner) },
+};
+
+boolean PlanetStep(byte inner, uint16_t stage) {
+  PlanetJob *p = &planetJobs[inner];
+
+  if (stage == 0) {
+    time_t t = now();
+    p->jd = get_julian_date(day(t), month(t), year(t), hour(t), minute(t), second(t));  // local - since year 4713 BC
+    p->jdFrac = jd_frac;
+
+  #ifdef FEATURE_SERIAL_PLANETARY
+    Serial.println("JD:" + String(p->jd, DEC) + "+" + String(p->jdFrac, DEC));  // jd = 2457761.375000;
+  #endif
+  }
+
+  if (stage < OBJECT_POSITION_EARTH) {  //earth -- must be included always
+    get_object_position_part(2, p->jd, p->jdFrac, stage, &p->work);
+    if (stage < OBJECT_POSITION_EARTH - 1) return false;
+    p->earth[0] = x_earth;
+    p->earth[1] = y_earth;
+    p->earth[2] = z_earth;
+    p->earth[3] = dist_earth_to_sun;
+    return false;
+  }
+
+  byte i = (stage - OBJECT_POSITION_EARTH) / OBJECT_POSITION_PARTS;  // planet
+  x_earth = p->earth[0];
+  y_earth = p->earth[1];
+  z_earth = p->earth[2];
+  dist_earth_to_sun = p->earth[3];
+  if (!get_object_position_part(p->objects[i], p->jd, p->jdFrac, (stage - OBJECT_POSITION_EARTH) % OBJECT_POSITION_PARTS, &p->work)) return false;
+  p->planets[i] = { altitudePlanet, azimuthPlanet, phase, magnitude };
+  return i == p->count - 1;
+}
+
+boolean PlanetStepOuter(uint16_t stage) { return PlanetStep(0, stage); }
+boolean PlanetStepInner(uint16_t stage) { return PlanetStep(1, stage); }
+
+uint32_t PlanetKey() {  // time to the minute, position
+  return JobKey(JobKey(now() / 60, round(100 * latitude)), round(100 * lon));
+}
+
+void PlanetPrefetch(byte inner) {  // in FACE_LIST
+  if (!gps.location.isValid()) return;
+  PositionFromGPS();
+  JobReady(&planetJobs[inner].job, PlanetKey());
+}
+
+/*****
+Purpose:
+Shows the position of a planet found by the planet job, or a placeholder until the job has been done once
+
+Argument List: byte i = index in planetJobs[].planets[]
+               byte inner = 1 for inner planets, else outer
+
+Return value: Displays on LCD
+*****/
+
+void LCDPlanet(byte i, byte inner) {
+  PlanetJob *p = &planetJobs[inner == 1];
+  if (!p->job.valid) lcd.print(F(" ...            "));
+  else if (inner == 1) LCDPlanetData(p->planets[i].altitude, p->planets[i].azimuth, p->planets[i].phase, p->planets[i].magnitude);
+  else LCDPlanetData(round(p->planets[i].altitude), round(p->planets[i].azimuth), p->planets[i].phase, p->planets[i].magnitude);
+}
+
 /*****
 Purpose: Menu item
 Shows info about 3 outer and 2 inner planets + alternates between solar/lunar info
@@ -3666,28 +4257,8 @@ void PlanetVisibility(byte inner  // inner = 1 for inner planets, all other valu
   if (gps.location.isValid())  // new 24.09.2024 - avoid giving planet positions for lat, lon = (0.0, 0.0)
   {
 
-    #ifndef DEBUG_MANUAL_POSITION    // new 24.09.2024 - avoid giving planet positions for lat, lon = (0.0, 0.0)
-      latitude = gps.location.lat();
-      lon = gps.location.lng();
-    #else
-      latitude = latitude_manual;
-      lon = longitude_manual;
-    #endif
-  
-    Seconds = second(now());
-    Minute = minute(now());
-    Hour = hour(now());
-    Day = day(now());
-    Month = month(now());
-    Year = year(now());
-
-    jd = get_julian_date(Day, Month, Year, Hour, Minute, Seconds);  // local - since year 4713 BC
-
-  #ifdef FEATURE_SERIAL_PLANETARY
-    Serial.println("JD:" + String(jd, DEC) + "+" + String(jd_frac, DEC));  // jd = 2457761.375000;
-  #endif
-
-    get_object_position(2, jd, jd_frac);  //earth -- must be included always
+    PositionFromGPS();  // new 24.09.2024 - avoid giving planet positions for lat, lon = (0.0, 0.0)
+    JobReady(&planetJobs[inner == 1].job, PlanetKey());  // positions of the minute before until done
 
     lcd.setCursor(0, 0);  // top line *********
     lcd.print(F("    El"));
@@ -3697,15 +4268,13 @@ void PlanetVisibility(byte inner  // inner = 1 for inner planets, all other valu
     lcd.print(F("   % Magn"));
 
     if (inner == 1) {
-      get_object_position(0, jd, jd_frac);    // Mercury
       lcd.setCursor(0, 2);
       lcd.print(F("Mer "));
-      LCDPlanetData(altitudePlanet, azimuthPlanet, phase, magnitude);
+      LCDPlanet(0, inner);
 
       lcd.setCursor(0, 3);
-      get_object_position(1, jd, jd_frac);    // Venus
       lcd.print(F("Ven "));
-      LCDPlanetData(altitudePlanet, azimuthPlanet, phase, magnitude);
+      LCDPlanet(1, inner);
 
       lcd.setCursor(0, 1);
       if ((now() / 10) % 2 == 0)  // change every 10 seconds
@@ -3730,23 +4299,17 @@ void PlanetVisibility(byte inner  // inner = 1 for inner planets, all other valu
 
     } else  // outer planets
     {
-      get_object_position(3, jd, jd_frac);  // Mars
       lcd.setCursor(0, 1);
       lcd.print(F("Mar "));
-      LCDPlanetData(round(altitudePlanet), round(azimuthPlanet), phase, magnitude);
+      LCDPlanet(0, inner);
 
-      get_object_position(4, jd, jd_frac);  // Jupiter
       lcd.setCursor(0, 2);
       lcd.print(F("Jup "));
-      LCDPlanetData(round(altitudePlanet), round(azimuthPlanet), phase, magnitude);
+      LCDPlanet(1, inner);
 
-      get_object_position(5, jd, jd_frac);  // Saturn
       lcd.setCursor(0, 3);
       lcd.print(F("Sat "));
-      LCDPlanetData(round(altitudePlanet), round(azimuthPlanet), phase, magnitude);
-
-      if (full) get_object_position(6, jd, jd_frac);  // Uranus
-      if (full) get_object_position(7, jd, jd_frac);  // Neptune
+      LCDPlanet(2, inner);
     }
   }
 }
@@ -3767,19 +4330,33 @@ const char HebrewMonth[13][10]  PROGMEM{ "Nisan    ", "Iyyar    ", "Sivan    ",
 int mIsl = 0;  // pointer to month name
 int mHeb = 0;   // pointer to month name
 
+// Hebrew date, found in steps by a job (clock_jobs.h), once per local day
+HebrewDate hebrewNext(0, 0, 0);  // being found by the job
+HebrewDate hebrewDate(0, 0, 0);  // published
+
+boolean HebrewDateStep(uint16_t stage);
+Job hebrewJob = { HebrewDateStep };
+
+boolean HebrewDateStep(uint16_t stage) {
+  if (stage == 0) hebrewNext = HebrewDate(0, 0, 0);
+  if (!hebrewNext.Step(long(hebrewJob.key))) return false;  // key = absolute date
+  hebrewDate = hebrewNext;
+  return true;
+}
+
+uint32_t HebrewKey() {  // local date, as absolute date
+  time_t t = now() + utcOffset * 60;
+  return long(GregorianDate(month(t), day(t), year(t)));
+}
+
+void HebrewPrefetch() {  // in FACE_LIST
+  JobReady(&hebrewJob, HebrewKey());
+}
+
 void ISOHebIslam() {  // ISOdate, Hebrew, Islamic
 
-unsigned int startTime;
-startTime = millis();  // // new 09.10.2024, keep track of time in order to compensate for long time in routine, for use in demo mode
 loadArrowCharacters();
 
-#ifdef FEATURE_DATE_PER_SECOND                                 // for stepping date quickly and check calender function
-  localTime = now() + utcOffset * 60 + dateIteration * SPEED_UP_FACTOR;  // fake local time by stepping up to 1 sec/day
-  dateIteration = dateIteration + 1;
-//  Serial.print(dateIteration); Serial.print(": ");
-//  Serial.println(localTime);
-#endif
-
   // algorithms in Nachum Dershowitz and Edward M. Reingold, Calendrical Calculations,
   // Software-Practice and Experience 20 (1990), 899-928
   // code from https://reingold.co/calendar.C
@@ -3814,7 +4391,7 @@ loadArrowCharacters();
 
     localTime = now() + utcOffset * 60; // added 3.2.2024 - less latency in time calculation as routine is entered and at full minute
     lcd.setCursor(11,0);
-    sprintf(textBuffer, "%02d%c%02d%c%02d ", hour(localTime), dateTimeFormat[dateFormat].hourSep, minute(localTime), dateTimeFormat[dateFormat].minSep, second(localTime));
+    FmtText(FmtTime(textBuffer, hour(localTime), minute(localTime), second(localTime)), " ");
     lcd.print(textBuffer);
 
     lcd.setCursor(11, 2);
@@ -3851,18 +4428,16 @@ loadArrowCharacters();
   mIsl = Isl.GetMonth();
   LcdDate(Isl.GetDay(), mIsl, Isl.GetYear());  
 
-  if (minuteGPS != oldMinute) {  // update rest of display initially and then every minute
+  if (faceRecompute) {  // every local day, see FACE_LIST, and when the Hebrew date has been found
     // Hebrew calendar is complicated and *** very *** slow - takes ~3 sec on Arduino Mega. 
-    // Therefore it is on the last line and only done occasionally
-    // means that ~3 updates of increments to 'demoDuration' are missed (i.e. seconds)
-    //           Serial.print(now());Serial.println(" Hebrew ...");
-    // lcd.setCursor(0, 3); lcd.print(F("..."));
-      HebrewDate Heb(a);
-      mHeb = Heb.GetMonth();
-      lcd.setCursor(0, 3); LcdDate(Heb.GetDay(), mHeb, Heb.GetYear());
+    // Therefore it is on the last line, and found in steps between the other tasks of loop()
+    // Until then the date of the day before is shown
+      JobReady(&hebrewJob, HebrewKey());
+      mHeb = hebrewDate.GetMonth();
+      lcd.setCursor(0, 3);
+      if (hebrewJob.valid) LcdDate(hebrewDate.GetDay(), mHeb, hebrewDate.GetYear());
+      else                 lcd.print(F("..."));
   }
-  oldMinute = minuteGPS;
-  elapsedTime = millis() - startTime;   // new 09.10.2024, estimate elapsed time in routine
 }
 
 /*****
@@ -3961,7 +4536,8 @@ void GPSInfo() {
     hdop = gps.hdop.hdop();  // in list of http://arduiniana.org/libraries/tinygpsplus/
     lcd.setCursor(0, 3);
     lcd.print(F("Hdop  "));
-    lcd.print(hdop);
+    FmtFixed(textBuffer, hdop, 0, 2);
+    lcd.print(textBuffer);
 
     if (hdop < 1) lcd.print(F(" Ideal    "));  // 1-2 Excellent, 2-5 Good https://en.wikipedia.org/wiki/Dilution_of_precision_(navigation)
     else if (hdop < 2) lcd.print(F(" Excellent"));
@@ -4020,7 +4596,6 @@ Return value: Displays on LCD
 
 void BigNumbers3(byte showUTC) {
   // big numbers 3 characters wide, 2 characters high
-  byte imax;
   byte lineno = 0;  // 0,1,2 first (=upper) line for big digits
 
   loadThreeWideDigits();  // load 8 user-defined characterS if not loaded
@@ -4045,11 +4620,9 @@ void BigNumbers3(byte showUTC) {
     Year = year(localTime);
   }
 
-  imax = Hour / 10;
-  draw_digit(imax, 0, lineno);  // draw 10's hour digit
-
-  imax = Hour % 10;
-  draw_digit(imax, 4, lineno);  // draw hour digit
+  BigDigitsBegin(&threeWideDigits);
+  BigDigit(0, Hour / 10, 0, lineno);  // draw 10's hour digit
+  BigDigit(1, Hour % 10, 4, lineno);  // draw hour digit
 
   // : (colon)
   lcd.setCursor(8, lineno);
@@ -4058,11 +4631,8 @@ void BigNumbers3(byte showUTC) {
   lcd.write(DOT);
 
 
-  imax = Minute / 10;
-  draw_digit(imax, 10, lineno);  // draw 10's minute digit
-
-  imax = Minute % 10;
-  draw_digit(imax, 14, lineno);  // draw minute digit
+  BigDigit(2, Minute / 10, 10, lineno);  // draw 10's minute digit
+  BigDigit(3, Minute % 10, 14, lineno);  // draw minute digit
 
   lcd.setCursor(18, 1);
   PrintFixedWidth(lcd, Seconds, 2, '0');
@@ -4095,7 +4665,6 @@ Return value: Displays on LCD
 
 void BigNumbers2(byte showUTC) {
   // Big numbers 2 characters wide, 3 high
-  byte imax;
   byte lineno = 0;  // 0,1 first (=upper) line for big digits
   byte start = 0;   // start row for characters: left-justified: 0, ~centered: 1,2
 
@@ -4120,33 +4689,21 @@ void BigNumbers2(byte showUTC) {
     Year = year(localTime);
   }
 
-  imax = Hour / 10;
-  // draw 10's hour digit
-  doNumber2(imax, lineno, start);
+  BigDigitsBegin(&threeHighDigits);
+  BigDigit(0, Hour / 10, start, lineno);        // draw 10's hour digit
+  BigDigit(1, Hour % 10, start + 3, lineno);    // draw hour digit
+  BigDigit(2, Minute / 10, start + 6, lineno);  // draw 10's minute digit
+  BigDigit(3, Minute % 10, start + 9, lineno);  // draw minute digit
+  BigDigit(4, Seconds / 10, start + 12, lineno);  // draw 10's second digit
+  BigDigit(5, Seconds % 10, start + 15, lineno);  // draw second digit
 
-  imax = Hour % 10;
-  // draw hour digit
-  doNumber2(imax, lineno, start + 3);
-
-  doNumber2(11, lineno, start + 5);  // colon
-
-  imax = Minute / 10;
-  // draw 10's minute digit
-  doNumber2(imax, lineno, start + 6);
-
-  imax = Minute % 10;
-  // draw minute digit
-  doNumber2(imax, lineno, start + 9);
-
-  doNumber2(11, lineno, start + 11);  // colon
-
-  imax = Seconds / 10;
-  // draw 10's second digit
-  doNumber2(imax, lineno, start + 12);
-
-  imax = Seconds % 10;
-  // draw second digit
-  doNumber2(imax, lineno, start + 15);
+  for (byte r = lineno; r < lineno + 2; r++)  // colons
+  {
+    lcd.setCursor(start + 5, r);
+    lcd.write(byte(BIG_COLON));
+    lcd.setCursor(start + 11, r);
+    lcd.write(byte(BIG_COLON));
+  }
 
   if (lineno != 2) {
     lcd.setCursor(18, 3);
@@ -4199,16 +4756,21 @@ void Reminder()  //
     return;
   }
 
-  float timeToBirthday[lengthPersonData + 2];
-  float diffYearsF[lengthPersonData + 2];
-  int indexArray[lengthPersonData + 2];
-  float Age1970[lengthPersonData + 2];
-  int diffDays[lengthPersonData + 2];
+  // from scratch arena, as length is only known at run time:
+  float *timeToBirthday = ScratchArray<float>(lengthPersonData + 2);
+  float *diffYearsF     = ScratchArray<float>(lengthPersonData + 2);
+  int   *indexArray     = ScratchArray<int>  (lengthPersonData + 2);
+  float *Age1970        = ScratchArray<float>(lengthPersonData + 2);
+  int   *diffDays       = ScratchArray<int>  (lengthPersonData + 2);
+  if (diffDays == NULL) {  // the last one fails first
+    lcd.setCursor(0, 0);  lcd.print(F("Reminder()"));
+    lcd.setCursor(0, 1);  lcd.print(F("Out of scratch RAM"));
+    return;
+  }
 
   if (strcmp(languages[languageNumber], "nb ") == 0 || strcmp(languages[languageNumber], "nn ") == 0)
     { 
-      loadAring();  // Å for Norwegian 
-      yearSymbol = char(SCAND_aa_SMALL);  // Scandinavian å
+      yearSymbol = TextCharacter(0x00E5);  // Scandinavian å, custom character (clock_language.h)
     }
   else yearSymbol = 'y';                  // 'English for 'year' = default
 
@@ -4285,7 +4847,7 @@ void Reminder()  //
           LcdDate(person[indexArray[ind]].Day, person[indexArray[ind]].Month, 0);  // Birth date: Day, Month
           lcd.print(F("  "));
           lcd.setCursor(15, ind - indStart);
-          dtostrf(diffYearsF[indexArray[ind]], 4, 1, textBuffer);  
+          FmtFixed(textBuffer, diffYearsF[indexArray[ind]], 4, 1);
           lcd.print(textBuffer); lcd.print(yearSymbol);                            // 1. Age in decimal years
         }
       else if (secondInternal % holdTimeReminderScreen >= holdTimeReminderScreen*2/3) // 13.12.2024
@@ -4343,28 +4905,28 @@ EquinoxSolstice(displayYear);
   lcd.setCursor(0,0); lcd.print(displayYear); //lcd.print(F(" UTC "));
   lcd.setCursor(9,0); 
   LcdDate(day(tt), month(tt));
-  sprintf(textBuffer, " %02d%c%02d", hour(tt), dateTimeFormat[dateFormat].hourSep, minute(tt));
+  FmtTime(FmtText(textBuffer, " "), hour(tt), minute(tt));
   lcd.print(textBuffer);  //lcd.print(F(" Equinox")); 
 
   tt = summerSolstice*86400 + utcOffset * 60;  // local time 22.12.2024
   lcd.setCursor(9,1); //lcd.cursor();
   LcdDate(day(tt), month(tt));
 
-  sprintf(textBuffer, " %02d%c%02d", hour(tt), dateTimeFormat[dateFormat].hourSep, minute(tt));
+  FmtTime(FmtText(textBuffer, " "), hour(tt), minute(tt));
   lcd.print(textBuffer); //lcd.print(F(" Solstice"));
     
   tt = autumnEquinox*86400 + utcOffset * 60;  // local time 22.12.2024;
   lcd.setCursor(0,2); lcd.print(F("Equinox "));
   lcd.setCursor(9,2);
   LcdDate(day(tt), month(tt));
-  sprintf(textBuffer, " %02d%c%02d", hour(tt), dateTimeFormat[dateFormat].hourSep, minute(tt));
+  FmtTime(FmtText(textBuffer, " "), hour(tt), minute(tt));
   lcd.print(textBuffer); 
 
   tt = winterSolstice*86400 + utcOffset * 60;  // local time 22.12.2024;
   lcd.setCursor(0,3); lcd.print(F("Solstice "));
   lcd.setCursor(9,3);
   LcdDate(day(tt), month(tt));
-  sprintf(textBuffer, " %02d%c%02d", hour(tt), dateTimeFormat[dateFormat].hourSep, minute(tt));
+  FmtTime(FmtText(textBuffer, " "), hour(tt), minute(tt));
   lcd.print(textBuffer); 
 
   oldMinute = minuteGPS;
@@ -4540,8 +5102,9 @@ timeNow = now();   // [for testing ... + 86400*270;] 15.11.2031
 int displayYear = year(timeNow);
 
 int lengthData = 4;   // no of events to sort
-float eventDate[lengthData + 2];  // in compact format: day + 100*month + 100000 for next year. Must be ... + 2 in length
-int indices[lengthData + 2];      // for sorting, near end of function
+float *eventDate = ScratchArray<float>(lengthData + 2);  // in compact format: day + 100*month + 100000 for next year. Must be ... + 2 in length
+int *indices     = ScratchArray<int>(lengthData + 2);    // for sorting, near end of function
+if (indices == NULL) return;                             // out of scratch RAM
 
 // *** Solstice & Equinoxes ***
 
@@ -4738,7 +5301,7 @@ void Progress()
       languageNumber = languageNumberStored;  // recall original language number
     }
 
-if (minuteGPS != oldMinute) {  // only update once per minute in order to avoid blink
+if (faceRecompute) {  // once per minute, see FACE_LIST
    loadCurvedFramedBarCharactersA();     // ( xxxx )
   
 // Progress bars
@@ -4772,7 +5335,6 @@ if (minuteGPS != oldMinute) {  // only update once per minute in order to avoid
     PrintFixedWidth(lcd, doy, 3);
   // https://gist.github.com/jrleeman/3b7c10712112e49d8607
   }
- oldMinute = minuteGPS;
 }
 
 
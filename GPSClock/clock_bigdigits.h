@@ -0,0 +1,75 @@
+// Big digits over several lines of the display, only drawn where they have changed
+
+/*
+BigDigitsBegin
+BigDigit
+ */
+
+// A style is a table in PROGMEM with the cells of each digit 0...9, width x height characters, top row first, see
+// threeWideCells[] and threeHighCells[] in clock_helper_routines.h. The characters are the slots of the style's custom
+// characters, or blank.
+//
+// bigShown[] remembers which digit is in the shadow copy of the display (clock_lcd.h) at each position, so BigDigit()
+// only writes the 6 or 9 cells of a digit which has changed, usually just the seconds (or minutes) ones digit. All
+// are drawn again after a clear (new screen, demo mode, custom characters loaded) or when another style was drawn.
+//
+// The cells of a digit are on 2 or 3 rows, and lcd.drain() sends changed characters row by row in time slices. At the
+// minute rollover, with 3 or 4 digits changing, the upper halves of the new digits could then be seen above the lower
+// halves of the old ones. BigDigitsBegin() therefore has the frame sent by one lcd.drain(), see ShadowLcd::atOnce()
+
+struct BigDigitStyle
+{
+  uint8_t width, height;        // characters of each digit
+  const uint8_t *cells;         // PROGMEM: 10 digits of width x height characters
+};
+
+#define BIG_DIGITS_MAX 6        // digit positions on a screen
+#define BIG_DIGIT_NONE 255      // not drawn
+
+const BigDigitStyle *bigStyle = NULL;  // style of previous call
+uint8_t bigClears;                     // lcd.clears at previous call
+uint8_t bigShown[BIG_DIGITS_MAX];      // digit at each position
+
+/*****
+Purpose:
+Starts drawing big digits of a style. Forgets the digits shown if the display has been cleared or the style has changed
+
+Argument List: const BigDigitStyle *style
+
+Return value: none
+*****/
+
+void BigDigitsBegin(const BigDigitStyle *style)
+{
+  if (style != bigStyle || lcd.clears != bigClears) memset(bigShown, BIG_DIGIT_NONE, sizeof(bigShown));
+  bigStyle = style;
+  bigClears = lcd.clears;
+  lcd.atOnce();
+}
+
+/*****
+Purpose:
+Draws a big digit, unless it is already shown at this position
+
+Argument List: byte position = 0...BIG_DIGITS_MAX-1, the digit's place on the screen, e.g. 0 = 10's hour
+               byte digit = 0...9
+               byte col, row = upper left-hand corner
+
+Return value: none
+*****/
+
+void BigDigit(byte position, byte digit, byte col, byte row)
+{
+  if (bigShown[position] == digit) return;
+  bigShown[position] = digit;
+
+  byte width = bigStyle->width;
+  const uint8_t *cell = bigStyle->cells + digit * width * bigStyle->height;
+  for (byte r = 0; r < bigStyle->height; r++)
+  {
+    lcd.setCursor(col, row + r);
+    for (byte c = 0; c < width; c++) lcd.write(pgm_read_byte(cell++));
+  }
+}
+
+// THE END /////
@@ -14,10 +14,27 @@
 //#define FEATURE_SERIAL_EEPROM  // debug EEPROM read
 //#define FEATURE_SERIAL_LOAD_CHARACTERS  // check loading of new custom characters to LCD
 //#define FEATURE_SERIAL_NEXTEVENTS  // debug NextEvent()
+//#define FEATURE_SERIAL_BENCHMARK  // time all screens of "All" subset for fixed dates, CSV with microseconds and LCD bytes per screen.
+                                    // Runs once after GPS fix. With DEBUG_MANUAL_POSITION it also steps through a set of positions
+//#define FEATURE_SERIAL_BENCHMARK_KERNELS  // time of each astronomy, calendar and formatting computation, JSON on serial port at startup
+//#define FEATURE_SERIAL_FLOATCOST  // with FEATURE_SERIAL_BENCHMARK: measures time per sin, cos, sqrt etc and adds no of calls 
+                                    // and their estimated time per screen to benchmark output (clock_floatcost.h)
+//#define FEATURE_SERIAL_GOLDEN  // display contents of all screens of "All" subset at fixed dates, all time zones, languages
+                                  // (and positions with DEBUG_MANUAL_POSITION) on serial port. Diff with a known good capture
 
-// LocalUTC(), WordClockNorwegian(), LcdSolarRiseSet(), ISOHebIslam():
-//#define FEATURE_DATE_PER_SECOND   // for stepping date/hour/min (86400/3600/60 sec step) quickly and check calender function (local time only)
-#define SPEED_UP_FACTOR 60.0 //3600, 86400;  // muliplied by date and added to time (seconds)
+//#define FEATURE_SERIAL_FOOTPRINT  // build profile (clock_options.h), flash and RAM used, on serial port at startup
+
+//#define FEATURE_PROFILER  // execution time (min, mean, p99, max) per screen, shown in ScreenProfiler. Uses ca 1.5 kB RAM
+//#define FEATURE_DIAGNOSTICS  // loop time, UART receive buffer overflow, GPS checksum errors, lost $GPGSV,
+                               // shown in ScreenDiagnostics and once per minute on serial port
+                               // also time and deadline misses of the tasks of loop(), shown in ScreenTasks (clock_tasks.h)
+
+// All screens: virtual time instead of GPS time, for stepping date/hour/min quickly and check calender functions, DST changes etc
+// (replaces FEATURE_DATE_PER_SECOND, which only worked in LocalUTC(), WordClockNorwegian(), LcdSolarRiseSet(), ISOHebIslam())
+//#define FEATURE_TIME_WARP   // speed and slowest screen per simulated day on serial port. Type new factor + Enter in serial monitor, not with FEATURE_FAKE_SERIAL_GPS_IN
+#define TIME_WARP_FACTOR 60         // virtual seconds per second, 3600, 86400, 0 = as fast as possible
+#define TIME_WARP_STEP   60         // with factor 0: seconds per loop()
+#define TIME_WARP_START  1735689600 // UTC, 01.01.2025 00:00:00
 
 //#define FEATURE_DAY_PER_SECOND    // for stepping through day names quickly
 
@@ -58,6 +75,11 @@
 //#define FEATURE_FAKE_SERIAL_GPS_IN  // for faking GPS from a GPS simulator (https://github.com/panaaj/nmeasimulator)
 // Demo 12.03.2022: didn't work properly with Time Zones & sidereal time, where clock does not advance when this mode is enabled
 
+// Must only be used alone, see clock_session.h:
+//#define FEATURE_SESSION_RECORD  // all input from GPS, PPS and rotary encoder to serial port, for capture to a file
+//#define FEATURE_SESSION_REPLAY  // input from a captured file via serial port instead of GPS, PPS and rotary encoder
+//#define SESSION_REPLAY_FAST     // with FEATURE_SESSION_REPLAY: as fast as possible, not with original timing
+
 // Must only be used alone. Don't use if you do not exactly understand this switch:
 // Switches GPS input from Serial1 to Serial to fake missing GPS coverage for demo purposes:
 // Ex: enter this in appropriate COMx window of Arduino GUI at 9600 baud:
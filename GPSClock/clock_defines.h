@@ -1,78 +1,94 @@
-// Define variables for Screen system - used in clock_options.h
-// numbers here must correspond to those of menuSystem()
-// Don't touch these!
+// Clock faces: each one is declared once here, in FACE_LIST - used in clock_options.h and by ScreenSelect()
+// The Screen numbers are given by the order of the list. Add new faces before ScreenDemoClock, and don't move the
+// others, as profiler, benchmark, and BUILD_SCREEN (clock_options.h) use the numbers
 
-// Clock faces of v1.0.0:
-#define ScreenLocalUTC      0
-#define ScreenUTCLocator    1
-#define ScreenLocalSun      2
-#define ScreenLocalSunMoon  3
-#define ScreenLocalMoon     4
-#define ScreenMoonRiseSet   5
-#define ScreenTimeZones     6
-#define ScreenBinary        7
-#define ScreenBinaryHorBCD  8
-#define ScreenBinaryVertBCD 9
-#define ScreenBar           10
-#define ScreenMengenLehrUhr 11
-#define ScreenLinearUhr     12
-#define ScreenInternalTime  13
-#define ScreenCodeStatus    14
-#define ScreenUTCPosition   15
-#define ScreenNCDXFBeacons2 16  
-#define ScreenNCDXFBeacons1 17 
-#define ScreenWSPRsequence  18
-#define ScreenHex           19
-#define ScreenOctal         20
+// FACE(id, draw, name, needs, refresh, period, dwell, prefetch)
+//   id      = Screen number, used in menuStruct[] (clock_options.h)
+//   draw    = the call which draws the face, demoMode = 1 when called from DemoClock(), otherwise 0
+//   name    = for serial output, at most 12 characters
+//   needs   = FACE_LOCATION | FACE_GLYPHS
+//   refresh = inputs of the face's expensive part, which is skipped (faceRecompute false) when none of them has
+//             changed: LAYOUT_SECOND (every second), LAYOUT_MINUTE, LAYOUT_DAY, LAYOUT_POSITION, LAYOUT_TOGGLE
+//             (every period seconds), REFRESH_SKY, see CadenceBegin() in clock_layout.h. 0 = none, for DemoClock()
+//   period  = seconds for LAYOUT_TOGGLE, otherwise 0
+//   dwell   = least no of seconds in demo mode, e.g. to see both views of a face which alternates. 0 = dwellTimeDemo
+//   prefetch = starts the jobs (clock_jobs.h) of the face, while the face before it is shown in demo mode, see
+//             clock_demo.h. (void)0 = none
 
-// New in v1.0.3:
-#define ScreenHexOctalClock 21
+#define FACE_LOCATION 0x01  // computed from or shows the GPS position
+#define FACE_GLYPHS   0x02  // loads its own set of custom characters (CGRAM), see glyphs() in clock_lcd.h
 
-// New in v1.0.4:
-#define ScreenEasterDates   22
+#define REFRESH_SKY (LAYOUT_MINUTE | LAYOUT_POSITION)  // sun and moon: time and place
 
-// New in v1.2.0:
-#define ScreenLocalSunSimpler   23
-#define ScreenLocalSunAzEl      24
-
-#define ScreenMathClockAdd      25
-#define ScreenMathClockSubtract 26
-#define ScreenMathClockMultiply 27
-#define ScreenMathClockDivide   28
-#define ScreenLunarEclipse      29
-
-// New in v1.3.0:
-#define ScreenRoman             30 
-#define ScreenMorse             31
-#define ScreenWordClock         32
-#define ScreenSidereal          33
-
-// New in v1.5.0:
-#define ScreenLocalUTCWeek      34
-#define ScreenPlanetsInner      35
-#define ScreenPlanetsOuter      36
-#define ScreenISOHebIslam       37
-#define ScreenGPSInfo           38
-
-// New in v1.6.0:
-#define ScreenChemical          39 
-
-// New in v2.1.0
-#define ScreenBigNumbers2       40
-#define ScreenBigNumbers2UTC    41
-#define ScreenBigNumbers3       42
-#define ScreenBigNumbers3UTC    43
-#define ScreenReminder          44
-
-// New in v2.2.0
-#define ScreenEquinoxes         45
-#define ScreenSolarEclipse      46
-#define ScreenNextEvents        47
-
-// new in v2.3.0 ?
-#define ScreenProgress          48
-
-// New in v1.3.0:
-#define ScreenDemoClock         49  // must be the last one
+#define FACE_LIST(FACE) \
+  /* Clock faces of v1.0.0: */ \
+  FACE(ScreenLocalUTC,          LocalUTC(0),          "LocalUTC",     FACE_LOCATION,               LAYOUT_SECOND,               0,  0, (void)0               ) \
+  FACE(ScreenUTCLocator,        UTCLocator(1),        "UTCLocator",   FACE_LOCATION,               LAYOUT_SECOND,               0,  0, (void)0               ) \
+  FACE(ScreenLocalSun,          LocalSun(0),          "LocalSun",     FACE_LOCATION | FACE_GLYPHS, REFRESH_SKY,                 0,  0, (void)0               ) \
+  FACE(ScreenLocalSunMoon,      LocalSunMoon(),       "LocalSunMoon", FACE_LOCATION | FACE_GLYPHS, REFRESH_SKY,                 0,  0, (void)0               ) \
+  FACE(ScreenLocalMoon,         LocalMoon(),          "LocalMoon",    FACE_LOCATION | FACE_GLYPHS, REFRESH_SKY,                 0,  0, (void)0               ) \
+  FACE(ScreenMoonRiseSet,       MoonRiseSet(),        "MoonRiseSet",  FACE_LOCATION | FACE_GLYPHS, REFRESH_SKY,                 0,  0, MoonRiseSetPrefetch() ) \
+  FACE(ScreenTimeZones,         TimeZones(),          "TimeZones",    0,                           LAYOUT_SECOND,               0,  0, (void)0               ) \
+  FACE(ScreenBinary,            Binary(2),            "Binary",       0,                           LAYOUT_SECOND,               0,  0, (void)0               ) \
+  FACE(ScreenBinaryHorBCD,      Binary(1),            "BinaryHorBCD", 0,                           LAYOUT_SECOND,               0,  0, (void)0               ) \
+  FACE(ScreenBinaryVertBCD,     Binary(0),            "BinaryVerBCD", 0,                           LAYOUT_SECOND,               0,  0, (void)0               ) \
+  FACE(ScreenBar,               Bar(),                "Bar",          FACE_GLYPHS,                 LAYOUT_SECOND,               0,  0, (void)0               ) \
+  FACE(ScreenMengenLehrUhr,     MengenLehrUhr(),      "MengenLehr",   0,                           LAYOUT_SECOND,               0,  0, (void)0               ) \
+  FACE(ScreenLinearUhr,         LinearUhr(),          "LinearUhr",    FACE_GLYPHS,                 LAYOUT_SECOND,               0,  0, (void)0               ) \
+  FACE(ScreenInternalTime,      InternalTime(),       "InternalTime", 0,                           LAYOUT_SECOND,               0,  0, (void)0               ) \
+  FACE(ScreenCodeStatus,        CodeStatus(),         "CodeStatus",   0,                           LAYOUT_SECOND,               0,  0, (void)0               ) \
+  FACE(ScreenUTCPosition,       UTCPosition(),        "UTCPosition",  FACE_LOCATION,               LAYOUT_SECOND,               0,  0, (void)0               ) \
+  FACE(ScreenNCDXFBeacons2,     NCDXFBeacons(2),      "NCDXF 18-28",  FACE_LOCATION,               LAYOUT_SECOND,               0,  0, (void)0               ) \
+  FACE(ScreenNCDXFBeacons1,     NCDXFBeacons(1),      "NCDXF 14-21",  FACE_LOCATION,               LAYOUT_SECOND,               0,  0, (void)0               ) \
+  FACE(ScreenWSPRsequence,      WSPRsequence(),       "WSPR",         FACE_GLYPHS,                 LAYOUT_SECOND,               0,  0, (void)0               ) \
+  FACE(ScreenHex,               HexOctalClock(0),     "Hex",          0,                           LAYOUT_SECOND,               0,  0, (void)0               ) \
+  FACE(ScreenOctal,             HexOctalClock(1),     "Octal",        0,                           LAYOUT_SECOND,               0,  0, (void)0               ) \
+  /* New in v1.0.3: */ \
+  FACE(ScreenHexOctalClock,     HexOctalClock(3),     "HexOctalBin",  0,                           LAYOUT_SECOND,               0,  0, (void)0               ) \
+  /* New in v1.0.4: */ \
+  FACE(ScreenEasterDates,       EasterDates(yearGPS), "EasterDates",  0,                           LAYOUT_MINUTE,               0,  0, (void)0               ) \
+  /* New in v1.2.0: */ \
+  FACE(ScreenLocalSunSimpler,   LocalSun(2),          "LocalSun2",    FACE_LOCATION | FACE_GLYPHS, REFRESH_SKY | LAYOUT_TOGGLE, 10, 20, (void)0               ) \
+  FACE(ScreenLocalSunAzEl,      LocalSunAzEl(),       "LocalSunAzEl", FACE_LOCATION | FACE_GLYPHS, REFRESH_SKY,                 0,  0, (void)0               ) \
+  FACE(ScreenMathClockAdd,      MathClock(0),         "MathAdd",      0,                           LAYOUT_SECOND,               0,  0, (void)0               ) \
+  FACE(ScreenMathClockSubtract, MathClock(1),         "MathSubtract", 0,                           LAYOUT_SECOND,               0,  0, (void)0               ) \
+  FACE(ScreenMathClockMultiply, MathClock(2),         "MathMultiply", 0,                           LAYOUT_SECOND,               0,  0, (void)0               ) \
+  FACE(ScreenMathClockDivide,   MathClock(3),         "MathDivide",   0,                           LAYOUT_SECOND,               0,  0, (void)0               ) \
+  FACE(ScreenLunarEclipse,      LunarEclipse(),       "LunarEclipse", 0,                           LAYOUT_MINUTE,               0,  0, LunarEclipsePrefetch()) \
+  /* New in v1.3.0: */ \
+  FACE(ScreenRoman,             Roman(),              "Roman",        0,                           LAYOUT_SECOND,               0,  0, (void)0               ) \
+  FACE(ScreenMorse,             Morse(),              "Morse",        0,                           LAYOUT_SECOND,               0,  0, (void)0               ) \
+  FACE(ScreenWordClock,         WordClock(),          "WordClock",    0,                           LAYOUT_SECOND,               0,  0, (void)0               ) \
+  FACE(ScreenSidereal,          Sidereal(),           "Sidereal",     FACE_LOCATION,               LAYOUT_SECOND,               0,  0, (void)0               ) \
+  /* New in v1.5.0: */ \
+  FACE(ScreenLocalUTCWeek,      LocalUTC(1),          "LocalUTCWeek", FACE_LOCATION,               LAYOUT_SECOND,               0,  0, (void)0               ) \
+  FACE(ScreenPlanetsInner,      PlanetVisibility(1),  "PlanetsInner", FACE_LOCATION,               LAYOUT_SECOND,               0, 20, PlanetPrefetch(1)     ) \
+  FACE(ScreenPlanetsOuter,      PlanetVisibility(0),  "PlanetsOuter", FACE_LOCATION,               LAYOUT_SECOND,               0,  0, PlanetPrefetch(0)     ) \
+  FACE(ScreenISOHebIslam,       ISOHebIslam(),        "ISOHebIslam",  FACE_GLYPHS,                 LAYOUT_DAY,                  0, 20, HebrewPrefetch()      ) \
+  FACE(ScreenGPSInfo,           GPSInfo(),            "GPSInfo",      0,                           LAYOUT_SECOND,               0,  0, (void)0               ) \
+  /* New in v1.6.0: */ \
+  FACE(ScreenChemical,          LocalUTC(2),          "Chemical",     FACE_LOCATION,               LAYOUT_SECOND,               0,  0, (void)0               ) \
+  /* New in v2.1.0: */ \
+  FACE(ScreenBigNumbers2,       BigNumbers2(0),       "BigNumbers2",  FACE_GLYPHS,                 LAYOUT_SECOND,               0,  0, (void)0               ) \
+  FACE(ScreenBigNumbers2UTC,    BigNumbers2(1),       "BigNumb2UTC",  FACE_GLYPHS,                 LAYOUT_SECOND,               0,  0, (void)0               ) \
+  FACE(ScreenBigNumbers3,       BigNumbers3(0),       "BigNumbers3",  FACE_GLYPHS,                 LAYOUT_SECOND,               0,  0, (void)0               ) \
+  FACE(ScreenBigNumbers3UTC,    BigNumbers3(1),       "BigNumb3UTC",  FACE_GLYPHS,                 LAYOUT_SECOND,               0,  0, (void)0               ) \
+  FACE(ScreenReminder,          Reminder(),           "Reminder",     0,                           LAYOUT_SECOND,               0, 15, (void)0               ) \
+  /* New in v2.2.0: */ \
+  FACE(ScreenEquinoxes,         Equinoxes(),          "Equinoxes",    0,                           LAYOUT_SECOND,               0,  0, (void)0               ) \
+  FACE(ScreenSolarEclipse,      SolarEclipse(),       "SolarEclipse", 0,                           LAYOUT_SECOND,               0,  0, (void)0               ) \
+  FACE(ScreenNextEvents,        NextEvents(),         "NextEvents",   0,                           LAYOUT_SECOND,               0,  0, (void)0               ) \
+  /* New in v2.3.0: */ \
+  FACE(ScreenProgress,          Progress(),           "Progress",     FACE_GLYPHS,                 LAYOUT_MINUTE,               0,  0, (void)0               ) \
+  /* New in v2.4.0, debugging: */ \
+  FACE(ScreenProfiler,          FACE_PROFILER,        "Profiler",     0,                           LAYOUT_SECOND,               0,  0, (void)0               )  /* only with FEATURE_PROFILER */ \
+  FACE(ScreenDiagnostics,       FACE_DIAGNOSTICS,     "Diagnostics",  0,                           LAYOUT_SECOND,               0,  0, (void)0               )  /* only with FEATURE_DIAGNOSTICS */ \
+  FACE(ScreenTasks,             FACE_TASKS,           "Tasks",        0,                           LAYOUT_SECOND,               0,  0, (void)0               )  /* only with FEATURE_DIAGNOSTICS */ \
+  /* New in v1.3.0: */ \
+  FACE(ScreenDemoClock,         DemoClock(demoMode),  "Demo",         0,                           0,                           0,  0, (void)0               )  /* must be the last one */
 
+#define FACE_ID(id, draw, name, needs, refresh, period, dwell, prefetch) id,
+enum ScreenId {FACE_LIST(FACE_ID) noOfFaces};
 
+static_assert(noOfFaces <= noOfScreens, "noOfScreens must be at least the no of faces in FACE_LIST");
+static_assert(ScreenDemoClock == noOfFaces - 1, "ScreenDemoClock must be the last face in FACE_LIST");
@@ -0,0 +1,135 @@
+// Demo mode: order of the faces as a playlist, and the jobs of the next face started while this one is shown
+
+/*
+InDemo
+DemoPlaylist
+DemoStart
+DemoNext
+DemoPrefetch
+ */
+
+// The playlist holds positions in menuStruct[subsetMenu], as demoDispState does. With demoStepType + or - it is the
+// subset in order or in reverse, with the position of DemoClock() itself, i.e. the banner, as before. With shuffle
+// it is a new random order for each round, without the banner, so that every face is shown once per round, and the
+// first one of a round is never the last one of the round before.
+//
+// Each face is shown for FaceDwell() seconds. While it is shown, DemoPrefetch() starts the jobs (clock_jobs.h) of the
+// next one, see prefetch in FACE_LIST (clock_defines.h), so that it has its data when it is drawn the first time
+
+void FacePrefetch(int screen);  // forward declaration
+
+byte demoPlaylist[noOfScreens];  // positions in menuStruct[subsetMenu]
+uint8_t demoLength = 0;          // no of positions in demoPlaylist
+uint8_t demoIndex = 0;           // the next one to show
+int demoBuiltFor = -1;           // subsetMenu and demoStepType the playlist was made for
+
+#define DEMO_BUILT_FOR (4 * subsetMenu + demoStepType)
+
+/*****
+Purpose:
+Tells if demo mode is chosen. Never if DemoClock() isn't in the subset, e.g. with BUILD_SCREEN, as its menuOrder[] is
+then MENU_NONE, which is no position
+
+Argument List: None
+
+Return value: true in demo mode
+*****/
+
+boolean InDemo()
+{
+  return (menuOrder[ScreenDemoClock] != MENU_NONE) && (dispState == menuOrder[ScreenDemoClock]);
+}
+
+/*****
+Purpose:
+Makes the playlist for a new round, given demoStepType and the position shown now, demoDispState
+
+Argument List: None
+
+Return value: None
+*****/
+
+void DemoPlaylist()
+{
+  int banner = menuOrder[ScreenDemoClock];
+  demoLength = 0;
+  demoBuiltFor = DEMO_BUILT_FOR;
+
+  if (demoStepType == 2)  // shuffle
+  {
+    for (int i = 0; i < noOfStates; i++)
+      if (i != banner) demoPlaylist[demoLength++] = i;
+    if (demoLength == 0) demoPlaylist[demoLength++] = banner;  // nothing but the banner in the subset
+
+    for (uint8_t i = demoLength - 1; i > 0; i--)  // Fisher-Yates
+    {
+      uint8_t j = random(0, i + 1);
+      byte swap = demoPlaylist[i];
+      demoPlaylist[i] = demoPlaylist[j];
+      demoPlaylist[j] = swap;
+    }
+    if ((demoLength > 1) && (demoPlaylist[0] == demoDispState))  // no repeat across rounds
+    {
+      demoPlaylist[0] = demoPlaylist[demoLength - 1];
+      demoPlaylist[demoLength - 1] = demoDispState;
+    }
+    demoIndex = 0;
+  }
+  else  // + or -
+  {
+    for (int i = 0; i < noOfStates; i++)
+      demoPlaylist[demoLength++] = (demoStepType == 1) ? noOfStates - 1 - i : i;
+    int shown = (demoDispState >= 0 && demoDispState < noOfStates) ? demoDispState : banner;
+    demoIndex = ((demoStepType == 1) ? noOfStates - shown : shown + 1) % demoLength;
+  }
+}
+
+/*****
+Purpose:
+Starts demo mode, from the banner of DemoClock()
+
+Argument List: None
+
+Return value: None
+*****/
+
+void DemoStart()
+{
+  demoDispState = dispState;  // start demo
+  demoDuration = 0;           // reset timer for time between screens in demo mode
+  DemoPlaylist();
+}
+
+/*****
+Purpose:
+Steps to the next face of the playlist, and makes a new playlist after the last one, or if the subset or the step
+type has been changed in the setup menu
+
+Argument List: None
+
+Return value: int position in menuStruct[subsetMenu], the new demoDispState
+*****/
+
+int DemoNext()
+{
+  if ((demoBuiltFor != DEMO_BUILT_FOR) || (demoIndex >= demoLength)) DemoPlaylist();
+  return demoPlaylist[demoIndex++];
+}
+
+/*****
+Purpose:
+Starts the jobs of the face which will be shown next, called once per second in demo mode. The prefetch of a face
+returns at once if its jobs are done, or running, for the inputs of now, e.g. the day and the position
+
+Argument List: None
+
+Return value: None
+*****/
+
+void DemoPrefetch()
+{
+  if ((demoBuiltFor != DEMO_BUILT_FOR) || (demoIndex >= demoLength)) DemoPlaylist();  // the next round
+  FacePrefetch(menuStruct[subsetMenu].order[demoPlaylist[demoIndex]]);
+}
+
+// THE END /////
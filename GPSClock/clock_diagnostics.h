@@ -0,0 +1,932 @@
+// Diagnostics: measurement of execution time and resources used by the clock faces
+
+/*
+LcdMilliseconds
+LcdCount
+
+BenchmarkSetTime
+BenchmarkScreens
+
+BenchmarkKernel
+BenchmarkKernels
+
+GoldenPrintFrame
+GoldenFrames
+
+TimeWarpRecord
+TimeWarpSerial
+TimeWarpStep
+
+ProfilerRecord
+ProfilerP99
+ProfilerRanking
+
+DiagnosticsReadGPS
+DiagnosticsGPGSV
+DiagnosticsSentence
+DiagnosticsSerial
+ */
+
+void ScreenSelect(int disp, int DemoMode);  // forward declaration
+#ifdef FEATURE_SERIAL_BENCHMARK
+const __FlashStringHelper *FaceName(int screen);  // forward declaration
+#endif
+
+/*****
+Purpose:
+Prints time in ms with 1 decimal, right-justified in 6 positions, e.g. "  12.3". Saturates at 9999.9
+
+Argument List: uint32_t us = time in microseconds
+
+Return value: Displays on LCD
+*****/
+
+void LcdMilliseconds(uint32_t us)
+{
+  uint32_t tenths = min((us + 50) / 100, uint32_t(99999));  // unit 0.1 ms
+  PrintFixedWidth(lcd, int(tenths / 10), 4);
+  lcd.print(".");
+  lcd.print(int(tenths % 10));
+}
+
+/*****
+Purpose:
+Prints unsigned count right-justified in a field, saturates at the largest value that fits, e.g. 9999 for width 4
+
+Argument List: uint32_t count
+               byte width = no of positions
+
+Return value: Displays on LCD
+*****/
+
+void LcdCount(uint32_t count, byte width)
+{
+  uint32_t largest = 9;
+  for (byte i = 1; (i < width) && (largest < 999999999UL); i++) largest = 10 * largest + 9;
+  count = min(count, largest);
+
+  byte digits = 1;
+  for (uint32_t temp = count; temp >= 10; temp /= 10) digits += 1;
+  for (byte i = digits; i < width; i++) lcd.print(" ");
+  lcd.print(count);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+#if defined(FEATURE_SERIAL_BENCHMARK) || defined(FEATURE_SERIAL_BENCHMARK_KERNELS) || defined(FEATURE_SERIAL_GOLDEN) || defined(FEATURE_TIME_WARP)
+
+// UTC instants for the benchmark, chosen to exercise rollovers and the astronomical screens:
+const uint32_t benchTimes[] PROGMEM = {
+  1741935480,  // 14.03.2025 06:58:00 total lunar eclipse
+  1743296390,  // 30.03.2025 00:59:50 10 sec before start of European summer time
+  1750473720,  // 21.06.2025 02:42:00 summer solstice
+  1767221995,  // 31.12.2025 22:59:55 5 sec before midnight, CET
+  1786556760,  // 12.08.2026 17:46:00 total solar eclipse
+  1835438400   // 29.02.2028 12:00:00 leap day
+};
+#define NO_BENCH_TIMES (sizeof(benchTimes) / sizeof(benchTimes[0]))
+
+#ifdef DEBUG_MANUAL_POSITION  // step through these positions, otherwise use GPS position
+const float benchPositions[][2] PROGMEM = {  // latitude, longitude
+  { 59.91,     10.75},      // Oslo
+  { 51.5,       0.0},       // London
+  { 32.656360, -85.395540}, // EM72hp
+  { 28.6,      77.2},       // New Dehli
+  {-33.92,     18.42}       // Cape Town
+};
+  #define NO_BENCH_POSITIONS (sizeof(benchPositions) / sizeof(benchPositions[0]))
+#else
+  #define NO_BENCH_POSITIONS 1
+#endif
+
+
+/*****
+Purpose:
+Sets the clock and the variables otherwise set by syncTimeGPS() to a given UTC time
+
+Argument List: time_t t = UTC
+
+Return value: none
+*****/
+
+void BenchmarkSetTime(time_t t)
+{
+  setTime(t);
+  SetTimeVariables();
+}
+#endif
+
+#ifdef FEATURE_SERIAL_BENCHMARK
+
+boolean benchmarkDone = false;
+
+/*****
+Purpose:
+Runs every screen of the "All" subset for a set of fixed times (and positions if DEBUG_MANUAL_POSITION)
+Each screen is called twice per time: first with oldMinute = -1, i.e. including its once-a-minute work,
+then one second later, which is the ordinary per-second refresh.
+Prints CSV on serial port: time in microseconds, no of characters/commands sent to the LCD,
+and total no of custom characters uploaded (i.e. not already loaded)
+Screens with a layout (clock_layout.h): total no of fields formatted and skipped as their inputs hadn't changed
+Total no of calls which recomputed, and which only refreshed the time (cadence in FACE_LIST), and the face's name
+With LCD_I2C_BATCH also no of I2C transactions and bytes to the LCD. Compare with characters + commands: without
+batching each of them takes at least one transaction
+With FEATURE_SERIAL_FLOATCOST also no of math function calls and their estimated time
+
+Runs once, after the first GPS fix, as screens need a valid position.
+Time is restored at the next syncTimeGPS()
+
+Argument List: none
+
+Return value: Serial output
+*****/
+
+void BenchmarkScreens()
+{
+  int8_t oldSubsetMenu = subsetMenu;
+  subsetMenu = 0;       // "All"
+  InitScreenSelect();
+  jobsAtOnce = true;    // faces complete in their first call, see clock_jobs.h
+
+#ifdef FEATURE_SERIAL_FLOATCOST
+  FloatCostMeasure();
+#endif
+  Serial.print(F("screen,calls,first_max_us,max_us,mean_us,mean_lcd_bytes,mean_lcd_cmds,glyph_uploads,fields_formatted,fields_skipped,recomputed,recompute_avoided"));
+#ifdef LCD_I2C_BATCH
+  Serial.print(F(",mean_i2c_frames,mean_i2c_bytes"));
+#endif
+#ifdef FEATURE_SERIAL_FLOATCOST
+  Serial.print(F(",mean_math_calls,mean_math_us"));
+#endif
+  Serial.println(F(",name"));
+
+  for (int screen = 0; screen < noOfScreens; screen++)
+  {
+    if (screen == ScreenDemoClock || menuOrder[screen] >= noOfStates) continue;  // not in "All", or would call other screens
+
+    uint32_t calls = 0, firstMax = 0, maxTime = 0, totalTime = 0, lcdBytes = 0, lcdCommands = 0, glyphUploads = 0;
+    uint32_t fieldsFormatted = layoutFormatted, fieldsSkipped = layoutSkipped;  // counted from startup
+    uint32_t facesRecomputed = cadenceRecomputed, facesAvoided = cadenceAvoided;
+#ifdef LCD_I2C_BATCH
+    uint32_t i2cFrames = 0, i2cBytes = 0;
+#endif
+#ifdef FEATURE_SERIAL_FLOATCOST
+    uint32_t mathCalls = 0, mathTime = 0;
+#endif
+
+    for (byte position = 0; position < NO_BENCH_POSITIONS; position++)
+    {
+#ifdef DEBUG_MANUAL_POSITION
+      latitude_manual  = pgm_read_float(&benchPositions[position][0]);
+      longitude_manual = pgm_read_float(&benchPositions[position][1]);
+#endif
+      for (byte i = 0; i < NO_BENCH_TIMES; i++)
+      {
+        time_t benchTime = pgm_read_dword(&benchTimes[i]);
+        lcd.clear();
+        oldMinute = -1;  // the first call does the once-a-minute computations
+
+        for (byte pass = 0; pass < 2; pass++)
+        {
+          BenchmarkSetTime(benchTime + pass);
+          lcd.resetCounters();
+#ifdef LCD_I2C_BATCH
+          lcd.resetBusCounters();
+#endif
+#ifdef FEATURE_SERIAL_FLOATCOST
+          FloatCostReset();
+#endif
+
+          uint32_t startTime = micros();
+          lcd.beginFrame();
+          ScreenSelect(menuOrder[screen], 0);
+          lcd.commit();
+          uint32_t duration = micros() - startTime;
+
+          calls       += 1;
+          totalTime   += duration;
+          maxTime      = max(maxTime, duration);
+          if (pass == 0) firstMax = max(firstMax, duration);
+          lcdBytes    += lcd.bytesWritten;
+          lcdCommands += lcd.commandsWritten;
+          glyphUploads += lcd.glyphUploads;
+#ifdef LCD_I2C_BATCH
+          i2cFrames   += lcd.i2cFrames;
+          i2cBytes    += lcd.i2cBytes;
+#endif
+#ifdef FEATURE_SERIAL_FLOATCOST
+          uint32_t mathCallsNow;
+          mathTime  += FloatCostEstimate(mathCallsNow);
+          mathCalls += mathCallsNow;
+#endif
+        }
+      }
+    }
+
+    Serial.print(screen);              Serial.print(F(","));
+    Serial.print(calls);               Serial.print(F(","));
+    Serial.print(firstMax);            Serial.print(F(","));
+    Serial.print(maxTime);             Serial.print(F(","));
+    Serial.print(totalTime / calls);   Serial.print(F(","));
+    Serial.print(lcdBytes / calls);    Serial.print(F(","));
+    Serial.print(lcdCommands / calls); Serial.print(F(","));
+    Serial.print(glyphUploads);        Serial.print(F(","));
+    Serial.print(layoutFormatted - fieldsFormatted); Serial.print(F(","));
+    Serial.print(layoutSkipped - fieldsSkipped);   Serial.print(F(","));
+    Serial.print(cadenceRecomputed - facesRecomputed); Serial.print(F(","));
+    Serial.print(cadenceAvoided - facesAvoided);
+#ifdef LCD_I2C_BATCH
+    Serial.print(F(","));              Serial.print(i2cFrames / calls);
+    Serial.print(F(","));              Serial.print(i2cBytes / calls);
+#endif
+#ifdef FEATURE_SERIAL_FLOATCOST
+    Serial.print(F(","));              Serial.print(mathCalls / calls);
+    Serial.print(F(","));              Serial.print(mathTime / calls);
+#endif
+    Serial.print(F(","));              Serial.println(FaceName(screen));
+  }
+
+  subsetMenu = oldSubsetMenu;
+  InitScreenSelect();
+  jobsAtOnce = false;
+  dispState = 0;
+  lcd.clear();
+  oldMinute = -1;
+  prevDisplay = 0;
+  benchmarkDone = true;
+  Serial.println(F("Benchmark done"));
+}
+
+#endif  // FEATURE_SERIAL_BENCHMARK
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef FEATURE_SERIAL_BENCHMARK_KERNELS
+
+// The heavy computations behind the screens, timed one at a time
+enum { K_MOONRISESET, K_NEXTRISESET, K_MOONPOSITION, K_MOONPHASE,
+       K_MERCURY, K_VENUS, K_EARTH, K_MARS, K_JUPITER, K_SATURN,
+       K_MOONECLIPSE, K_EQUINOX, K_EASTER,
+       K_GREGORIAN, K_JULIAN, K_ISLAMIC, K_HEBREW, K_ISO,
+       K_SPRINTF_TIME, K_FMT_TIME, K_DTOSTRF, K_FMT_FIXED, NO_KERNELS };
+
+const char kernelNames[NO_KERNELS][20] PROGMEM = {
+  "GetMoonRiseSetTimes", "GetNextRiseSet", "UpdateMoonPosition", "MoonPhaseAccurate",
+  "planet Mercury", "planet Venus", "planet Earth", "planet Mars", "planet Jupiter", "planet Saturn",
+  "MoonEclipse", "EquinoxSolstice", "ComputeEasterDate",
+  "GregorianDate", "JulianDate", "IslamicDate", "HebrewDate", "IsoDate",
+  "sprintf time", "FmtTime", "dtostrf", "FmtFixed"};
+
+volatile long kernelSink;  // results are written here, so the compiler can't remove the computation
+
+/*****
+Purpose:
+Runs one kernel once
+
+Argument List: byte kernel = K_...
+
+Return value: none
+*****/
+
+void BenchmarkKernel(byte kernel)
+{
+  short pRise, pSet;
+  double rAz, sAz;
+  int order;
+  float phase, percentPhase;
+  int pDate[10], eYear[10];
+  int paschalFullMoon, easterDate, easterMonth;
+  GregorianDate a(month(localTime), day(localTime), year(localTime));
+
+  switch (kernel)
+  {
+    case K_MOONRISESET:
+      GetMoonRiseSetTimes(float(utcOffset) / 60.0, latitude, lon, &pRise, &rAz, &pSet, &sAz);
+      kernelSink = pRise;
+      break;
+    case K_NEXTRISESET:
+      GetNextRiseSet(&pRise, &rAz, &pSet, &sAz, &order);
+      kernelSink = pRise;
+      break;
+    case K_MOONPOSITION:
+      UpdateMoonPosition();
+      break;
+    case K_MOONPHASE:
+      MoonPhaseAccurate(phase, percentPhase);
+      kernelSink = long(percentPhase);
+      break;
+    case K_MERCURY: case K_VENUS: case K_EARTH: case K_MARS: case K_JUPITER: case K_SATURN:
+      get_object_position(kernel - K_MERCURY, jd, jd_frac);
+      break;
+    case K_MOONECLIPSE:
+      for (byte i = 0; i < 10; i++) pDate[i] = 0;
+      MoonEclipse(year(localTime), pDate, eYear);
+      kernelSink = pDate[0];
+      break;
+    case K_EQUINOX:
+      EquinoxSolstice(year(localTime));
+      break;
+    case K_EASTER:
+      ComputeEasterDate(year(localTime), -2, -10, &paschalFullMoon, &easterDate, &easterMonth);
+      kernelSink = easterDate;
+      break;
+    case K_GREGORIAN: { GregorianDate g(long(a) + 1000); kernelSink = g.GetDay(); break; }
+    case K_JULIAN:    { JulianDate j(a);                 kernelSink = j.GetDay(); break; }
+    case K_ISLAMIC:   { IslamicDate i(a);                kernelSink = i.GetDay(); break; }
+    case K_HEBREW:    { HebrewDate h(a);                 kernelSink = h.GetDay(); break; }
+    case K_ISO:       { IsoDate iso(a);                  kernelSink = iso.GetWeek(); break; }
+
+    // formatting, before and after clock_format.h
+    case K_SPRINTF_TIME:
+      sprintf(textBuffer, "%02d%c%02d%c%02d", hour(utc), dateTimeFormat[dateFormat].hourSep, minute(utc), dateTimeFormat[dateFormat].minSep, second(utc));
+      kernelSink = textBuffer[7];
+      break;
+    case K_FMT_TIME:
+      FmtTime(textBuffer, hour(utc), minute(utc), second(utc));
+      kernelSink = textBuffer[7];
+      break;
+    case K_DTOSTRF:
+      dtostrf(latitude, 8, 4, textBuffer);
+      kernelSink = textBuffer[7];
+      break;
+    case K_FMT_FIXED:
+      FmtFixed(textBuffer, latitude, 8, 4);
+      kernelSink = textBuffer[7];
+      break;
+  }
+}
+
+/*****
+Purpose:
+Times each kernel at a fixed time and position (first entry of benchTimes, Oslo), prints JSON on serial port
+One warm-up call decides the no of repetitions (ca 0.2 s, max 100) per run; 3 runs per kernel.
+Capture the output to a file and compare between versions.
+Runs at end of setup(), before GPS has set the time
+
+Argument List: none
+
+Return value: Serial output
+*****/
+
+void BenchmarkKernels()
+{
+  const byte RUNS = 3;
+
+  latitude = 59.91;
+  lon      = 10.75;
+  BenchmarkSetTime(pgm_read_dword(&benchTimes[0]));
+  jd = get_julian_date(day(utc), month(utc), year(utc), hour(utc), minute(utc), second(utc));
+
+  Serial.print(F("{\"version\": \""));  Serial.print(codeVersion);
+  Serial.print(F("\", \"cpu_mhz\": "));   Serial.print(F_CPU / 1000000UL);
+  Serial.println(F(", \"kernels\": ["));
+
+  for (byte kernel = 0; kernel < NO_KERNELS; kernel++)
+  {
+    uint32_t startTime = micros();
+    BenchmarkKernel(kernel);  // warm-up
+    uint32_t warmUp = max(micros() - startTime, uint32_t(1));
+    uint16_t repetitions = constrain(200000UL / warmUp, 1UL, 100UL);
+
+    float minTime = 1e30, sumTime = 0;  // ns per call
+    for (byte run = 0; run < RUNS; run++)
+    {
+      startTime = micros();
+      for (uint16_t i = 0; i < repetitions; i++) BenchmarkKernel(kernel);
+      float nsPerCall = 1000.0 * (micros() - startTime) / repetitions;
+      minTime = min(minTime, nsPerCall);
+      sumTime += nsPerCall;
+    }
+
+    char name[20];
+    strcpy_P(name, kernelNames[kernel]);
+    Serial.print(F("  {\"name\": \""));           Serial.print(name);
+    Serial.print(F("\", \"repetitions\": "));     Serial.print(repetitions);
+    Serial.print(F(", \"runs\": "));              Serial.print(RUNS);
+    Serial.print(F(", \"ns_per_op_min\": "));     Serial.print(minTime, 0);
+    Serial.print(F(", \"ns_per_op_mean\": "));    Serial.print(sumTime / RUNS, 0);
+    Serial.println(kernel < NO_KERNELS - 1 ? F("},") : F("}"));
+  }
+  Serial.println(F("]}"));
+
+  prevDisplay = 0;
+  oldMinute = -1;
+}
+
+#endif  // FEATURE_SERIAL_BENCHMARK_KERNELS
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef FEATURE_SERIAL_GOLDEN
+
+boolean goldenDone = false;
+
+/*****
+Purpose:
+Prints the copy of the display kept by ShadowLcd on serial port, one line per row between '|'
+Custom characters and other non-ASCII bytes are printed as \xx (hex), '\' as \5C
+
+Argument List: uint16_t &crc = CRC-16 (CCITT) of all frames so far, updated
+
+Return value: Serial output
+*****/
+
+void GoldenPrintFrame(uint16_t &crc)
+{
+  for (byte row = 0; row < LCD_ROWS; row++)
+  {
+    Serial.print(F("|"));
+    for (byte col = 0; col < LCD_COLS; col++)
+    {
+      uint8_t c = lcd.frame[row][col];
+      if (c >= ' ' && c < 0x7F && c != '\\') Serial.write(c);
+      else
+      {
+        Serial.print(F("\\"));
+        if (c < 0x10) Serial.print(F("0"));
+        Serial.print(c, HEX);
+      }
+
+      crc ^= uint16_t(c) << 8;
+      for (byte bit = 0; bit < 8; bit++) crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    Serial.println(F("|"));
+  }
+}
+
+/*****
+Purpose:
+Renders every screen of the "All" subset at the fixed times of the benchmark (benchTimes) and prints the
+resulting display contents on serial port. Capture it to a file and compare (diff) with a capture from a
+known good version in order to see if a change has altered any screen layout.
+Variants: every time zone in English, every language in the first time zone, and with DEBUG_MANUAL_POSITION
+every position of benchPositions. A product of all of these would take hours on the processor.
+Ends with no of frames and a CRC of all of them, which is quick to compare.
+
+Runs once, after the first GPS fix, as screens need a valid position.
+Time is restored at the next syncTimeGPS()
+
+Argument List: none
+
+Return value: Serial output
+*****/
+
+void GoldenFrames()
+{
+  int8_t oldSubsetMenu = subsetMenu, oldTimeZone = timeZoneNumber, oldLanguage = languageNumber;
+  const byte numLanguages = sizeof(languages) / sizeof(languages[0]);
+  const byte variants = NUMBER_OF_TIME_ZONES + (numLanguages - 1) + (NO_BENCH_POSITIONS - 1);
+  uint32_t frames = 0;
+  uint16_t crc = 0xFFFF;
+
+  subsetMenu = 0;       // "All"
+  InitScreenSelect();
+  jobsAtOnce = true;    // faces complete in their first call, see clock_jobs.h
+
+  for (byte variant = 0; variant < variants; variant++)
+  {
+    byte position = 0;
+    timeZoneNumber = 0;
+    languageNumber = 0;
+    if      (variant < NUMBER_OF_TIME_ZONES)                    timeZoneNumber = variant;
+    else if (variant < NUMBER_OF_TIME_ZONES + numLanguages - 1) languageNumber = variant - NUMBER_OF_TIME_ZONES + 1;
+    else                                                        position = variant - NUMBER_OF_TIME_ZONES - numLanguages + 2;
+    tz = *timeZones_arr[timeZoneNumber];
+#ifdef DEBUG_MANUAL_POSITION
+    latitude_manual  = pgm_read_float(&benchPositions[position][0]);
+    longitude_manual = pgm_read_float(&benchPositions[position][1]);
+#endif
+
+    for (int screen = 0; screen < noOfScreens; screen++)
+    {
+      if (screen == ScreenDemoClock || menuOrder[screen] >= noOfStates) continue;  // not in "All", or would call other screens
+
+      for (byte i = 0; i < NO_BENCH_TIMES; i++)
+      {
+        time_t goldenTime = pgm_read_dword(&benchTimes[i]);
+        BenchmarkSetTime(goldenTime);
+        lcd.clear();
+        oldMinute = -1;
+        lcd.beginFrame();
+        ScreenSelect(menuOrder[screen], 0);
+        lcd.commit();
+
+        Serial.print(F("#"));   Serial.print(screen);
+        Serial.print(F(","));   Serial.print(timeZoneNumber);
+        Serial.print(F(","));   Serial.print(languages[languageNumber]);
+        Serial.print(F(","));   Serial.print(position);
+        Serial.print(F(","));   Serial.println(goldenTime);
+        GoldenPrintFrame(crc);
+        frames++;
+      }
+    }
+  }
+
+  subsetMenu = oldSubsetMenu;
+  timeZoneNumber = oldTimeZone;
+  languageNumber = oldLanguage;
+  tz = *timeZones_arr[timeZoneNumber];
+  InitScreenSelect();
+  jobsAtOnce = false;
+  dispState = 0;
+  lcd.clear();
+  oldMinute = -1;
+  prevDisplay = 0;
+  goldenDone = true;
+  Serial.print(F("Golden frames done: ")); Serial.print(frames);
+  Serial.print(F(" frames, CRC "));       Serial.println(crc, HEX);
+}
+
+#endif  // FEATURE_SERIAL_GOLDEN
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef FEATURE_TIME_WARP
+
+// Virtual UTC replaces GPS time, so all screens see the same accelerated time via now(), utc, localTime and *GPS variables.
+// timeWarpFactor = 0: as fast as the processor allows, time steps TIME_WARP_STEP seconds per loop()
+// Once per simulated day on serial port: real time used, speed achieved, slowest screen and no of screen updates
+// which took more than 1 sec, i.e. where the clock would fall behind in real time
+
+time_t   warpTime = TIME_WARP_START;   // virtual UTC
+uint16_t timeWarpFactor = TIME_WARP_FACTOR;
+uint32_t warpLastMillis = 0;
+uint32_t warpMs = 0;                   // virtual ms not yet added to warpTime
+uint16_t warpInput = 0;                // new factor being typed on serial port
+
+time_t   warpDayStart = 0;             // statistics for current simulated day
+uint32_t warpDayMillis;
+uint32_t warpMaxUs;
+int      warpMaxScreen;
+uint16_t warpUpdates, warpBehind;
+
+/*****
+Purpose:
+Records execution time of a screen update for the daily statistics
+
+Argument List: int screen = screen number (Screen... in clock_defines.h)
+               uint32_t duration = time in microseconds
+
+Return value: none
+*****/
+
+void TimeWarpRecord(int screen, uint32_t duration)
+{
+  warpUpdates++;
+  if (duration > 1000000UL) warpBehind++;
+  if (duration > warpMaxUs)
+  {
+    warpMaxUs = duration;
+    warpMaxScreen = screen;
+  }
+}
+
+/*****
+Purpose:
+Reads new speed-up factor typed in serial monitor, e.g. "3600" + Enter. "0" = as fast as possible
+
+Argument List: none
+
+Return value: none
+*****/
+
+void TimeWarpSerial()
+{
+  while (Serial.available())
+  {
+    char c = Serial.read();
+    if (c >= '0' && c <= '9') warpInput = 10 * warpInput + (c - '0');
+    else if (c == '\n')
+    {
+      timeWarpFactor = warpInput;
+      warpInput = 0;
+      warpMs = 0;
+      Serial.print(F("Time warp x")); Serial.println(timeWarpFactor);
+    }
+  }
+}
+
+/*****
+Purpose:
+Advances virtual time and sets the clock, replaces syncTimeGPS()
+
+Argument List: none
+
+Return value: none
+*****/
+
+void TimeWarpStep()
+{
+#ifndef FEATURE_FAKE_SERIAL_GPS_IN  // else the NMEA sentences come in on Serial, and TIME_WARP_FACTOR is kept
+  TimeWarpSerial();
+#endif
+
+  uint32_t nowMillis = millis();
+  if (timeWarpFactor == 0)
+    warpTime += TIME_WARP_STEP;
+  else
+  {
+    warpMs += (nowMillis - warpLastMillis) * timeWarpFactor;
+    warpLastMillis = nowMillis;
+    if (warpMs < 1000) return;  // less than 1 virtual sec since last time
+    warpTime += warpMs / 1000;
+    warpMs %= 1000;
+  }
+  warpLastMillis = nowMillis;
+
+  if (warpDayStart == 0 || day(warpTime) != day(warpDayStart))  // new simulated day
+  {
+    if (warpDayStart != 0)
+    {
+      uint32_t realMs = max(nowMillis - warpDayMillis, uint32_t(1));
+      Serial.print(year(warpDayStart));  Serial.print(F("-"));
+      Serial.print(month(warpDayStart)); Serial.print(F("-"));
+      Serial.print(day(warpDayStart));
+      Serial.print(F(", ms "));          Serial.print(realMs);
+      Serial.print(F(", x"));            Serial.print(1000.0 * (warpTime - warpDayStart) / realMs, 0);
+      Serial.print(F(", updates "));     Serial.print(warpUpdates);
+      Serial.print(F(", max us "));      Serial.print(warpMaxUs);
+      Serial.print(F(" screen "));       Serial.print(warpMaxScreen);
+      Serial.print(F(", behind "));      Serial.println(warpBehind);
+    }
+    warpDayStart = warpTime;
+    warpDayMillis = nowMillis;
+    warpMaxUs = 0;
+    warpMaxScreen = -1;
+    warpUpdates = 0;
+    warpBehind = 0;
+  }
+
+  tz = *timeZones_arr[timeZoneNumber];  // may have been changed in setup menu
+  BenchmarkSetTime(warpTime);
+}
+
+#endif  // FEATURE_TIME_WARP
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef FEATURE_PROFILER
+
+// Execution time of ScreenSelect() per screen, measured in updateDisplay() and shown by Profiler()
+// Histogram with 16 log2 bins: bin 0 < 128 us, bin k = [128*2^(k-1), 128*2^k) us, bin 15 >= 2.1 s
+// ca 30 bytes per screen
+#define PROFILER_BINS 16
+
+struct ScreenProfile
+{
+  uint16_t count;                    // no of calls (halved together with sumUs when full)
+  uint32_t sumUs;                    // for mean
+  uint32_t minUs;
+  uint32_t maxUs;
+  uint8_t histogram[PROFILER_BINS];  // all bins are halved when one is full, so old values fade out
+};
+
+ScreenProfile profile[noOfScreens];
+
+/*****
+Purpose:
+Adds one execution time to the statistics of a screen
+
+Argument List: int screen = Screen number as in clock_defines.h
+               uint32_t duration = time in microseconds
+
+Return value: none
+*****/
+
+void ProfilerRecord(int screen, uint32_t duration)
+{
+  if ((screen < 0) || (screen >= noOfScreens)) return;
+  ScreenProfile *p = &profile[screen];
+
+  if ((p->count == 0) || (duration < p->minUs)) p->minUs = duration;
+  if (duration > p->maxUs)                      p->maxUs = duration;
+
+  byte bin = 0;
+  uint32_t scaled = duration >> 7;  // unit 128 us
+  while ((scaled > 0) && (bin < PROFILER_BINS - 1))
+  {
+    scaled >>= 1;
+    bin += 1;
+  }
+
+  if ((p->histogram[bin] == 255) || (p->count == 65535) || (p->sumUs > 0xFFFFFFFF - duration))
+  {
+    for (byte i = 0; i < PROFILER_BINS; i++) p->histogram[i] >>= 1;
+    p->count >>= 1;
+    p->sumUs >>= 1;
+  }
+
+  p->histogram[bin] += 1;
+  p->count += 1;
+  p->sumUs += duration;
+}
+
+/*****
+Purpose:
+Estimates 99th percentile of execution time from histogram, upper edge of bin
+
+Argument List: int screen = Screen number as in clock_defines.h
+
+Return value: time in microseconds
+*****/
+
+uint32_t ProfilerP99(int screen)
+{
+  ScreenProfile *p = &profile[screen];
+  uint16_t total = 0;
+  for (byte i = 0; i < PROFILER_BINS; i++) total += p->histogram[i];
+
+  uint16_t limit = total - total / 100;  // no of calls at or below p99
+  uint16_t cumulative = 0;
+  for (byte i = 0; i < PROFILER_BINS - 1; i++)
+  {
+    cumulative += p->histogram[i];
+    if (cumulative >= limit) return min(uint32_t(128) << i, p->maxUs);
+  }
+  return p->maxUs;
+}
+
+/*****
+Purpose:
+Finds screens when sorted by decreasing p99, then max execution time
+
+Argument List: int firstRank = 0 for the worst screen
+               int screens[] = output, Screen numbers for rank firstRank ... firstRank + number - 1
+               byte number = no of screens to find
+
+Return value: no of screens found (fewer if not that many have been measured)
+*****/
+
+byte ProfilerRanking(int firstRank, int screens[], byte number)
+{
+  uint32_t previousP99 = 0xFFFFFFFF;
+  uint32_t previousMax = 0xFFFFFFFF;
+  int previousScreen = -1;
+  byte found = 0;
+
+  for (int rank = 0; rank < firstRank + number; rank++)  // repeated search for next in order, avoids a sorted list in RAM
+  {
+    int screen = -1;
+    uint32_t bestP99 = 0, bestMax = 0;
+    for (int i = 0; i < noOfScreens; i++)
+    {
+      if (profile[i].count == 0) continue;
+      uint32_t p99 = ProfilerP99(i);
+      uint32_t maxUs = profile[i].maxUs;
+
+      // only those after the previous one in (p99, max, screen number) order
+      boolean after = (p99 < previousP99) || ((p99 == previousP99) && ((maxUs < previousMax) ||
+                      ((maxUs == previousMax) && (i > previousScreen))));
+      boolean better = (screen < 0) || (p99 > bestP99) || ((p99 == bestP99) && (maxUs > bestMax));
+      if (after && better)
+      {
+        screen = i;
+        bestP99 = p99;
+        bestMax = maxUs;
+      }
+    }
+    if (screen < 0) break;  // no more measured screens
+
+    if (rank >= firstRank) screens[found++] = screen;
+    previousP99 = bestP99;
+    previousMax = bestMax;
+    previousScreen = screen;
+  }
+  return found;
+}
+
+#endif  // FEATURE_PROFILER
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef FEATURE_DIAGNOSTICS
+
+// readGPS() empties the UART receive buffer once per loop(). If a screen takes longer than it takes to fill the buffer
+// (64 bytes = 67 ms at 9600 bps on Mega), NMEA characters are lost and TinyGPS++ discards the sentence.
+// Shown in Diagnostics() and once per minute on serial port
+
+#ifndef SERIAL_RX_BUFFER_SIZE         // defined by AVR core
+  #ifdef SERIAL_BUFFER_SIZE           // SAMD core
+    #define SERIAL_RX_BUFFER_SIZE SERIAL_BUFFER_SIZE
+  #else
+    #define SERIAL_RX_BUFFER_SIZE 64
+  #endif
+#endif
+
+uint32_t lastReadGPS = 0;        // micros() at previous readGPS(), 0 = restart measurement
+uint32_t maxLoopGap = 0;         // longest time between two calls of readGPS(), us
+int maxLoopGapScreen = -1;       // screen shown when it happened
+uint32_t longLoopGaps = 0;       // no of times the time between two calls was long enough to fill the receive buffer
+uint32_t uartOverflows = 0;      // no of times the receive buffer was full when read, i.e. characters probably lost
+int lastOverflowScreen = -1;     // screen shown last time it happened
+uint32_t gpgsvSeen = 0;          // no of $GPGSV sentences decoded
+uint32_t gpgsvExpected = 0;      // no of $GPGSV sentences announced in the sentences
+int previousGPGSVMessage = 0;
+TinyGPSCustom gpgsvTotal(gps, "GPGSV", 1);   // own copies: value() of those in GPSParse() would clear isUpdated()
+TinyGPSCustom gpgsvNumber(gps, "GPGSV", 2);
+long lastDiagnosticsMinute = -1; // for serial output once per minute
+
+/*****
+Purpose:
+Measures time since previous call and checks for full UART receive buffer. Called first in readGPS()
+
+Argument List: int available = no of characters in UART receive buffer
+
+Return value: none
+*****/
+
+void DiagnosticsReadGPS(int available)
+{
+  uint32_t timeNow = micros();
+  if (lastReadGPS != 0)
+  {
+    uint32_t gap = timeNow - lastReadGPS;
+    if (gap > maxLoopGap)
+    {
+      maxLoopGap = gap;
+      maxLoopGapScreen = currentScreen;
+    }
+    if (gap > SERIAL_RX_BUFFER_SIZE * 10000000UL / gpsBaud) longLoopGaps += 1;  // 10 bits per character
+  }
+  lastReadGPS = timeNow;
+
+  if (available >= SERIAL_RX_BUFFER_SIZE - 1)  // ring buffer holds SERIAL_RX_BUFFER_SIZE - 1 characters
+  {
+    uartOverflows += 1;
+    lastOverflowScreen = currentScreen;
+  }
+}
+
+/*****
+Purpose:
+Counts $GPGSV sentences seen and expected. A cycle of totalMessages sentences starts
+with message 1, or is found when the message number doesn't increase (message 1 lost)
+
+Argument List: int totalMessages, int currentMessage = fields 1 and 2 of $GPGSV
+
+Return value: none
+*****/
+
+void DiagnosticsGPGSV(int totalMessages, int currentMessage)
+{
+  gpgsvSeen += 1;
+  if ((currentMessage == 1) || (currentMessage <= previousGPGSVMessage))
+    gpgsvExpected += totalMessages;
+  previousGPGSVMessage = currentMessage;
+}
+
+/*****
+Purpose:
+Called by GPSEncode() for each sentence which has been decoded with a valid checksum, so that every $GPGSV is
+counted, also when several of them arrive in one readGPS()
+
+Argument List: none
+
+Return value: none
+*****/
+
+void DiagnosticsSentence()
+{
+  if (gpgsvNumber.isUpdated()) DiagnosticsGPGSV(atoi(gpgsvTotal.value()), atoi(gpgsvNumber.value()));
+}
+
+/*****
+Purpose:
+Prints diagnostics on serial port once per minute
+
+Argument List: none
+
+Return value: Serial output
+*****/
+
+void DiagnosticsSerial()
+{
+  long minuteNow = now() / 60;
+  if (minuteNow == lastDiagnosticsMinute) return;
+  lastDiagnosticsMinute = minuteNow;
+
+  Serial.print(F("Max gap us "));      Serial.print(maxLoopGap);
+  Serial.print(F(" scr "));            Serial.print(maxLoopGapScreen);
+  Serial.print(F(", long gaps "));     Serial.print(longLoopGaps);
+  Serial.print(F(", UART full "));     Serial.print(uartOverflows);
+  Serial.print(F(" last scr "));       Serial.print(lastOverflowScreen);
+  Serial.print(F(", checksum err "));  Serial.print(gps.failedChecksum());
+  Serial.print(F(" of "));             Serial.print(gps.failedChecksum() + gps.passedChecksum());
+  Serial.print(F(", GPGSV "));         Serial.print(gpgsvSeen);
+  Serial.print(F("/"));                Serial.print(gpgsvExpected);
+  Serial.print(F(", LCD queue peak "));Serial.print(lcd.queuePeak);
+  Serial.print(F(", PPS-LCD us "));    Serial.print(latencyMean);
+  Serial.print(F(" max "));            Serial.print(latencyMax);
+  Serial.print(F(", recomputed "));    Serial.print(cadenceRecomputed);
+  Serial.print(F(" avoided "));        Serial.print(cadenceAvoided);
+#ifdef FEATURE_LCD_I2C
+  Serial.print(F(", I2C timeouts "));  Serial.print(i2cTimeouts);
+  Serial.print(F(" errors "));         Serial.print(lcd.writeErrors);
+  Serial.print(F(" restored "));       Serial.print(i2cRecoveries);
+#endif
+  Serial.print(F(", screen "));        Serial.println(currentScreen);
+}
+
+#endif  // FEATURE_DIAGNOSTICS
+
+// THE END /////
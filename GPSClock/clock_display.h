@@ -0,0 +1,254 @@
+// Display timing: next second drawn in advance and shown on the 1PPS pulse, and pulse-to-glass latency
+
+/*
+SetTimeVariables
+
+DisplayEdge
+DisplayShown
+
+DisplayHeld
+TimeVariablesAhead
+DisplayAhead
+
+LcdBusCheck
+ */
+
+// Without DISPLAY_ON_PPS, a screen is drawn when now() changes, i.e. after syncTimeGPS() has set the time following the
+// pulse, and the seconds on the display change when drawing and sending are done: up to several hundred ms late, and
+// different for each screen.
+//
+// With DISPLAY_ON_PPS, as soon as the present second has been sent, DisplayAhead() draws the next one with the clock
+// temporarily 1 second ahead, and the shadow copy of the display (clock_lcd.h) keeps it back. The first loop() after
+// the pulse releases it, so only sending the changed characters is left. Without the pulse (using_PPS false) the time
+// comes from the NMEA sentences, and the frame is released when that time changes, or 1000 ms after it last changed,
+// whichever comes first. A missing pulse is handled the same way, after 1100 ms.
+// If the screen is changed by the rotary encoder, lcd.clear() drops the held frame, and the new screen is drawn at once.
+//
+// Pulse-to-glass latency: time from the 1PPS interrupt until the last changed character of that second has been sent.
+// Measured when using_PPS, with and without DISPLAY_ON_PPS, shown on the 3rd page of the Diagnostics screen
+
+void DrawScreen();  // forward declaration
+
+/*****
+Purpose:
+Sets the variables otherwise set by syncTimeGPS() from now()
+
+Argument List: none
+
+Return value: none
+*****/
+
+void SetTimeVariables()
+{
+  utc        = now();
+  hourGPS    = hour(utc);
+  minuteGPS  = minute(utc);
+  secondGPS  = second(utc);
+  dayGPS     = day(utc);
+  monthGPS   = month(utc);
+  yearGPS    = year(utc);
+  weekdayGPS = weekday(utc);
+
+#ifdef AUTO_UTC_OFFSET
+  localTime = tz.toLocal(utc, &tcr);
+  utcOffset = localTime / long(60) - utc / long(60);  // min, order of calculation is important
+#else
+  localTime = utc + utcOffset * 60;                   // utcOffset set manually in clock_options.h
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint32_t latencyEdge;           // micros() of the pulse for the frame being sent
+boolean  latencyPending = false;
+uint32_t latencyLast = 0;       // us
+uint32_t latencyMean = 0;       // us, running mean of the last ~16
+uint32_t latencyMin = 0xFFFFFFFF;
+uint32_t latencyMax = 0;
+uint32_t latencyCount = 0;
+
+void DisplayEdge()  // a frame for a new second has been handed to lcd.drain()
+{
+  if (!using_PPS) return;
+  noInterrupts();
+  latencyEdge = ppsMicros;
+  interrupts();
+  latencyPending = true;
+}
+
+void DisplayShown()  // lcd.drain() has sent all changed characters
+{
+  if (!latencyPending) return;
+  latencyPending = false;
+
+  latencyLast = micros() - latencyEdge;
+  if (latencyLast > 1000000UL) return;  // not for this pulse, e.g. released on a missing pulse
+  latencyCount += 1;
+  if (latencyCount == 1) latencyMean = latencyLast;
+  else latencyMean += (int32_t(latencyLast) - int32_t(latencyMean)) / 16;
+  latencyMin = min(latencyMin, latencyLast);
+  latencyMax = max(latencyMax, latencyLast);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef DISPLAY_ON_PPS
+
+time_t   heldSecond = 0;        // second of the frame held back, 0 = none
+time_t   tickSecond = 0;        // now() when last seen by DisplayHeld()
+uint32_t tickMillis = 0;        // millis() when now() last changed, or of last pulse
+boolean  ppsSeen = false;       // set by syncCheck() after syncTimeGPS() for a pulse
+
+/*****
+Purpose:
+Releases the held frame at the pulse, or at the predicted second without it. Called first in updateDisplay()
+
+Argument List: none
+
+Return value: true while a frame is held back, or when it was just released
+*****/
+
+boolean DisplayHeld()
+{
+  time_t timeNow = now();
+  boolean pulse = ppsSeen;
+  ppsSeen = false;
+  if (using_PPS ? pulse : timeNow != tickSecond) tickMillis = millis();
+  tickSecond = timeNow;
+
+  if (heldSecond == 0) return false;
+  if (!lcd.isHolding())  // dropped by lcd.clear()
+  {
+    heldSecond = 0;
+    return false;
+  }
+
+  uint32_t sinceTick = millis() - tickMillis;
+  if (using_PPS ? !pulse && sinceTick < 1100 : timeNow < heldSecond && sinceTick < 1000) return true;
+
+  lcd.releaseFrame();
+  DisplayEdge();
+  prevDisplay = heldSecond;
+  heldSecond = 0;
+  if (!pulse) tickMillis = millis();  // predicted second
+  return true;
+}
+
+/*****
+Purpose:
+Moves the variables set by syncTimeGPS() 1 second on, as they will be after the next pulse, or back. hourGPS etc.
+are moved on from their own values, not set from now(), as they are a second behind it when using_PPS
+
+Argument List: boolean ahead = true to save and move them on, false to restore them
+
+Return value: none
+*****/
+
+void TimeVariablesAhead(boolean ahead)
+{
+  static time_t savedUtc, savedLocalTime;
+  static tmElements_t savedGPS;
+
+  if (!ahead)
+  {
+    utc        = savedUtc;
+    localTime  = savedLocalTime;
+    hourGPS    = savedGPS.Hour;
+    minuteGPS  = savedGPS.Minute;
+    secondGPS  = savedGPS.Second;
+    dayGPS     = savedGPS.Day;
+    monthGPS   = savedGPS.Month;
+    yearGPS    = tmYearToCalendar(savedGPS.Year);
+    weekdayGPS = savedGPS.Wday;
+    return;
+  }
+
+  savedUtc = utc;
+  savedLocalTime = localTime;
+  savedGPS = { secondGPS, minuteGPS, hourGPS, weekdayGPS, dayGPS, monthGPS, (uint8_t)CalendarYrToTm(yearGPS) };
+
+  tmElements_t next;
+  breakTime(makeTime(savedGPS) + 1, next);
+  utc        = savedUtc + 1;
+  localTime  = savedLocalTime + 1;
+  hourGPS    = next.Hour;
+  minuteGPS  = next.Minute;
+  secondGPS  = next.Second;
+  dayGPS     = next.Day;
+  monthGPS   = next.Month;
+  yearGPS    = tmYearToCalendar(next.Year);
+  weekdayGPS = next.Wday;
+}
+
+/*****
+Purpose:
+Draws the next second when the present one has been sent, and holds it back until DisplayHeld() releases it
+
+Argument List: none
+
+Return value: none
+*****/
+
+void DisplayAhead()
+{
+  if (heldSecond != 0 || !lcd.drained()) return;
+
+  heldSecond = prevDisplay + 1;
+  adjustTime(1);   // unlike setTime(), this keeps the phase of the second
+  TimeVariablesAhead(true);
+  lcd.aheadFrame();  // custom characters uploaded with the frame, not before the pulse
+  DrawScreen();
+  adjustTime(-1);
+  TimeVariablesAhead(false);
+  lcd.holdFrame();
+}
+
+#endif  // DISPLAY_ON_PPS
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef FEATURE_LCD_I2C
+
+uint32_t i2cLastRecovery = 0;   // millis() of last attempt to restore the display
+
+/*****
+Purpose:
+Notices timeouts and failed writes on the I2C bus, and restores the display at most every LCD_I2C_RETRY ms,
+see clock_lcd_i2c.h. Called from loop() after lcd.drain(). Restoring is done in steps, one per call
+
+Argument List: none
+
+Return value: none
+*****/
+
+void LcdBusCheck()
+{
+#ifdef WIRE_HAS_TIMEOUT
+  if (Wire.getWireTimeoutFlag())
+  {
+    Wire.clearWireTimeoutFlag();
+    i2cTimeouts++;
+    lcd.failed = true;
+  }
+#endif
+  if (lcd.restoring())  // custom characters, one per pass of loop()
+  {
+    if (!lcd.failed)
+    {
+      lcd.restore();
+      return;
+    }
+    lcd.restoreCancel();
+  }
+  if (!lcd.failed || millis() - i2cLastRecovery < LCD_I2C_RETRY) return;
+
+  i2cLastRecovery = millis();
+  i2cRecoveries++;
+  I2cBusClear();
+  lcd.restore();  // first step: begin(), which starts Wire again, and reads the GPS from its delay() calls
+  I2cBusSetup();
+}
+
+#endif  // FEATURE_LCD_I2C
+
+// THE END /////
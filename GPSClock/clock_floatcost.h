@@ -0,0 +1,138 @@
+// Cost of floating point math library calls, for finding the screens that would gain most from optimization
+
+/*
+FloatCostMeasure
+FloatCostReset
+FloatCostEstimate
+ */
+
+// AVR has no floating point hardware, so every sin(), sqrt() etc is a software routine of hundreds to thousands of cycles.
+// With FEATURE_SERIAL_FLOATCOST all calls of the functions below in the code that follows this file are counted,
+// and the cost of each function is measured on the processor itself at startup.
+// BenchmarkScreens() (FEATURE_SERIAL_BENCHMARK) prints no of calls and estimated time per screen.
+// Calls inside libraries (SolarCalculator, moon2, TimeLib...) are not counted, as this file is included after them,
+// neither are +, -, *, /
+
+#ifdef FEATURE_SERIAL_FLOATCOST
+
+enum { FC_SIN, FC_COS, FC_TAN, FC_ASIN, FC_ACOS, FC_ATAN, FC_ATAN2, FC_SQRT, FC_LOG10, FC_FLOOR, FC_FMOD, FC_OPS };
+
+const char floatCostNames[FC_OPS][6] PROGMEM = {"sin", "cos", "tan", "asin", "acos", "atan", "atan2", "sqrt", "log10", "floor", "fmod"};
+
+uint32_t floatOpCount[FC_OPS];  // no of calls since FloatCostReset()
+uint16_t floatOpCost[FC_OPS];   // measured time per call, unit 1/16 us
+volatile float floatCostArg = 0.5;  // volatile, so the compiler can't remove the calls
+
+/*****
+Purpose:
+Measures time per call of each math function on this processor and prints the table on serial port
+
+Argument List: none
+
+Return value: none
+*****/
+
+void FloatCostMeasure()
+{
+  const int N = 200;  // calls per function
+  float sum = 0;
+  uint32_t startTime, emptyTime;
+
+  startTime = micros();
+  for (int i = 0; i < N; i++) sum += floatCostArg;
+  emptyTime = micros() - startTime;  // loop + addition, subtracted from the others
+
+  Serial.println(F("Math function, us/call"));
+  for (byte op = 0; op < FC_OPS; op++)
+  {
+    startTime = micros();
+    for (int i = 0; i < N; i++)
+    {
+      float x = floatCostArg;
+      switch (op)
+      {
+        case FC_SIN:   sum += sin(x);        break;
+        case FC_COS:   sum += cos(x);        break;
+        case FC_TAN:   sum += tan(x);        break;
+        case FC_ASIN:  sum += asin(x);       break;
+        case FC_ACOS:  sum += acos(x);       break;
+        case FC_ATAN:  sum += atan(x);       break;
+        case FC_ATAN2: sum += atan2(x, 0.7); break;
+        case FC_SQRT:  sum += sqrt(x);       break;
+        case FC_LOG10: sum += log10(x);      break;
+        case FC_FLOOR: sum += floor(x);      break;
+        case FC_FMOD:  sum += fmod(x, 0.3);  break;
+      }
+    }
+    uint32_t duration = micros() - startTime;
+    duration = (duration > emptyTime) ? duration - emptyTime : 0;
+    floatOpCost[op] = min(16 * duration / N, uint32_t(65535));
+
+    char name[6];
+    strcpy_P(name, floatCostNames[op]);
+    Serial.print(name); Serial.print(F(", ")); Serial.println(floatOpCost[op] / 16.0, 1);
+  }
+  floatCostArg = sum;  // use the result
+}
+
+void FloatCostReset()
+{
+  for (byte op = 0; op < FC_OPS; op++) floatOpCount[op] = 0;
+}
+
+/*****
+Purpose:
+Estimated time of math function calls counted since FloatCostReset()
+
+Argument List: uint32_t &calls = output, total no of calls
+
+Return value: estimated time in microseconds
+*****/
+
+uint32_t FloatCostEstimate(uint32_t &calls)
+{
+  uint32_t cost = 0;
+  calls = 0;
+  for (byte op = 0; op < FC_OPS; op++)
+  {
+    calls += floatOpCount[op];
+    cost  += floatOpCount[op] * floatOpCost[op] / 16;
+  }
+  return cost;
+}
+
+// Counting wrappers: a function call is a sequence point, so cos(x) * cos(y) counts two calls, where a comma
+// expression in the macro would modify the counter twice in one expression (undefined, -Wsequence-point)
+#define FLOAT_COST_1(f, op) \
+  static inline double FloatCost_##f(double x) { floatOpCount[op]++; return f(x); }
+#define FLOAT_COST_2(f, op) \
+  static inline double FloatCost_##f(double y, double x) { floatOpCount[op]++; return f(y, x); }
+
+FLOAT_COST_1(sin,   FC_SIN)
+FLOAT_COST_1(cos,   FC_COS)
+FLOAT_COST_1(tan,   FC_TAN)
+FLOAT_COST_1(asin,  FC_ASIN)
+FLOAT_COST_1(acos,  FC_ACOS)
+FLOAT_COST_1(atan,  FC_ATAN)
+FLOAT_COST_2(atan2, FC_ATAN2)
+FLOAT_COST_1(sqrt,  FC_SQRT)
+FLOAT_COST_1(log10, FC_LOG10)
+FLOAT_COST_1(floor, FC_FLOOR)
+FLOAT_COST_2(fmod,  FC_FMOD)
+
+// From here on, all calls are counted
+#define sin(x)      FloatCost_sin(x)
+#define cos(x)      FloatCost_cos(x)
+#define tan(x)      FloatCost_tan(x)
+#define asin(x)     FloatCost_asin(x)
+#define acos(x)     FloatCost_acos(x)
+#define atan(x)     FloatCost_atan(x)
+#define atan2(y, x) FloatCost_atan2(y, x)
+#define sqrt(x)     FloatCost_sqrt(x)
+#define log10(x)    FloatCost_log10(x)
+#define floor(x)    FloatCost_floor(x)
+#define fmod(x, y)  FloatCost_fmod(x, y)
+
+#endif  // FEATURE_SERIAL_FLOATCOST
+
+// THE END /////
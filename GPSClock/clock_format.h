@@ -0,0 +1,240 @@
+// Fixed-width formatting into a line buffer, instead of sprintf(), dtostrf() and print(float)
+
+/*
+FmtUnsigned
+FmtText
+FmtInt
+FmtFixed
+FmtTime
+FmtDate
+FmtBits
+ */
+
+// All functions write at p, NUL-terminate, and return a pointer to the terminating NUL, so that calls can be chained
+// into one line buffer:
+//
+//   char *p = FmtTime(textBuffer, Hour, Minute, Seconds);   // "22:30:46", separators from dateTimeFormat[dateFormat]
+//   FmtText(p, " UTC ");
+//   lcd.print(textBuffer);
+//
+// sprintf() pulls in vfprintf(), which on AVR costs more than 1 kB of flash and parses the format string at every call,
+// and dtostrf() and print(float) each bring their own float conversion. These use only integer division, and
+// FmtFixed() one float multiplication. Nothing is formatted beyond the given width, except that numbers which don't
+// fit are written in full, as with printf.
+//
+// With FEATURE_SERIAL_BENCHMARK_KERNELS, FmtTime() and FmtFixed() are timed against sprintf() and dtostrf().
+// For the flash saved, compare FEATURE_SERIAL_FOOTPRINT (or the size reported by the IDE) with an earlier version, built
+// without FEATURE_SERIAL_BENCHMARK_KERNELS, which brings sprintf() back
+
+/*****
+Purpose:
+Writes an unsigned number right-justified in a field
+
+Argument List: char *p = where to write
+               unsigned long value
+               int8_t width = min no of characters, 0 = as many as needed
+               char filler = ' ' or '0'
+               byte base = 10, 16 (upper case) or 8
+
+Return value: pointer to the terminating NUL
+*****/
+
+char *FmtUnsigned(char *p, unsigned long value, int8_t width = 0, char filler = ' ', byte base = 10)
+{
+  char digits[11];  // 2^32 in octal
+  byte n = 0;
+  do
+  {
+    byte digit = value % base;
+    digits[n++] = digit < 10 ? '0' + digit : 'A' + digit - 10;
+    value /= base;
+  } while (value != 0);
+
+  for (; width > n; width--) *p++ = filler;
+  while (n > 0) *p++ = digits[--n];
+  *p = '\0';
+  return p;
+}
+
+/*****
+Purpose:
+Writes text, right- or left-justified in a field, like "%12s", "%-12s" and "%3.3s"
+
+Argument List: char *p = where to write
+               const char *text
+               int8_t width = > 0: right-justified, < 0: left-justified, 0: as it is
+               byte maxLength = no of characters of text at most
+
+Return value: pointer to the terminating NUL
+*****/
+
+char *FmtText(char *p, const char *text, int8_t width = 0, byte maxLength = 255)
+{
+  byte length = strnlen(text, maxLength);
+  int8_t fill = abs(width) - length;
+
+  if (width > 0) for (; fill > 0; fill--) *p++ = ' ';
+  memcpy(p, text, length);
+  p += length;
+  if (width < 0) for (; fill > 0; fill--) *p++ = ' ';
+  *p = '\0';
+  return p;
+}
+
+/*****
+Purpose:
+Writes a signed number right-justified in a field. With filler '0' the sign comes first: width = 5 => '-0002'
+
+Argument List: as FmtUnsigned()
+
+Return value: pointer to the terminating NUL
+*****/
+
+char *FmtInt(char *p, long value, int8_t width = 0, char filler = ' ', byte base = 10)
+{
+  if (value >= 0) return FmtUnsigned(p, value, width, filler, base);
+
+  if (filler == '0')
+  {
+    *p++ = '-';
+    return FmtUnsigned(p, 0UL - value, width - 1, filler, base);
+  }
+
+  char digits[13];
+  char *q = FmtUnsigned(digits + 1, 0UL - value, 0, filler, base);
+  for (width -= q - digits; width > 0; width--) *p++ = ' ';  // q - digits = length incl '-'
+  digits[0] = '-';
+  return FmtText(p, digits);
+}
+
+/*****
+Purpose:
+Writes a number with a fixed no of decimals, right-justified in a field, like dtostrf()
+
+Argument List: char *p = where to write
+               float value = up to ca +/-4e9
+               int8_t width = min no of characters, 0 = as many as needed
+               byte decimals = 0...4
+
+Return value: pointer to the terminating NUL
+*****/
+
+char *FmtFixed(char *p, float value, int8_t width, byte decimals)
+{
+  char number[17];
+  char *q = number;
+  if (value < 0)
+  {
+    *q++ = '-';
+    value = -value;
+  }
+
+  unsigned long scale = 1;
+  for (byte i = 0; i < decimals; i++) scale *= 10;
+
+  unsigned long whole = value;
+  unsigned long fraction = (value - whole) * scale + 0.5;
+  if (fraction >= scale)  // rounded up to the next whole number
+  {
+    whole += 1;
+    fraction -= scale;
+  }
+
+  q = FmtUnsigned(q, whole);
+  if (decimals > 0)
+  {
+    *q++ = '.';
+    FmtUnsigned(q, fraction, decimals, '0');
+  }
+  return FmtText(p, number, width);
+}
+
+/*****
+Purpose:
+Writes a time with the separators of dateTimeFormat[dateFormat]: "22:30:46", or "22:30" without seconds
+
+Argument List: char *p = where to write
+               int Hour, Minute
+               int Second = -1: no seconds
+               byte base = 10, 16 or 8
+
+Return value: pointer to the terminating NUL
+*****/
+
+char *FmtTime(char *p, int Hour, int Minute, int Second = -1, byte base = 10)
+{
+  p = FmtUnsigned(p, Hour, 2, '0', base);
+  *p++ = dateTimeFormat[dateFormat].hourSep;
+  p = FmtUnsigned(p, Minute, 2, '0', base);
+  if (Second < 0) return p;
+
+  *p++ = dateTimeFormat[dateFormat].minSep;
+  return FmtUnsigned(p, Second, 2, '0', base);
+}
+
+/*****
+Purpose:
+Writes a date in the order and with the separator of dateTimeFormat[dateFormat]: day-month or day-month-year
+
+Argument List: char *p = where to write
+               int Day, Month
+               int Year = 0: no year
+
+Return value: pointer to the terminating NUL
+*****/
+
+char *FmtDate(char *p, int Day, int Month, int Year = 0)
+{
+  char dateSep = dateTimeFormat[dateFormat].dateSep;
+
+  if (dateTimeFormat[dateFormat].dateOrder == 'B')
+  {
+    if (Year != 0)
+    {
+      p = FmtInt(p, Year, 4);
+      *p++ = dateSep;
+    }
+    p = FmtInt(p, Month, 2, '0');
+    *p++ = dateSep;
+    return FmtInt(p, Day, 2, '0');
+  }
+
+  if (dateTimeFormat[dateFormat].dateOrder == 'M')
+  {
+    p = FmtInt(p, Month, 2, '0');
+    *p++ = dateSep;
+    p = FmtInt(p, Day, 2, '0');
+  }
+  else
+  {
+    p = FmtInt(p, Day, 2, '0');
+    *p++ = dateSep;
+    p = FmtInt(p, Month, 2, '0');
+  }
+  if (Year != 0)
+  {
+    *p++ = dateSep;
+    p = FmtInt(p, Year, 4);
+  }
+  return p;
+}
+
+/*****
+Purpose:
+Writes elements of a bit array from DecToBinary() as '0' and '1'
+
+Argument List: char *p = where to write
+               int bits[] = 0 or 1 in each element
+               byte first, last = indices of the first and last bit to write
+
+Return value: pointer to the terminating NUL
+*****/
+
+char *FmtBits(char *p, int bits[], byte first, byte last)
+{
+  for (byte i = first; i <= last; i++) *p++ = '0' + bits[i];
+  *p = '\0';
+  return p;
+}
+
+// THE END /////
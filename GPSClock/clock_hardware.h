@@ -70,6 +70,12 @@
 static const uint32_t gpsBaud1[] = {4800, 9600, 19200};
 
 //lcd pins
+#if defined(FEATURE_LCD_I2C)
+  #define LCD_I2C_CLOCK 400000          // Hz, I2C bus speed to the LCD, 100000 is the I2C default
+//#define LCD_I2C_BATCH                 // own transport (clock_lcd_i2c.h): PCF8574 backpack, usual wiring, address below
+  #define LCD_I2C_ADDRESS 0x27          // for LCD_I2C_BATCH, the library otherwise finds address and wiring itself
+#endif
+
 #if defined(FEATURE_LCD_4BIT) 
   #define lcd_rs 8
   #define lcd_enable 9 
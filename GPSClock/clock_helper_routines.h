@@ -53,10 +53,7 @@ ArrowCharacters
 BarCharacters
 
 ThreeWideDigits
-draw_digit
-
 ThreeHighDigits2
-doNumber2
 
 gapLessCharacters
 gapLessBar
@@ -473,43 +470,19 @@ void DecToBinary(int n, int binaryNum[])
 //////////////////////////////////////////////////
 
 void PrintFixedWidth(Print &out, int number, byte width, char filler = ' ') {
-  int temp = number;
   //
   // Sverre Holm 2022
   // call like this to print number to lcd: PrintFixedWidth(lcd, val, 3);
   // or for e.g. minutes PrintFixedWidth(lcd, minute, 2, '0')
   //
   // Default filler = ' ', can also be set to '0' e.g. for clock
-  // If filler = ' ', it handles negative integers: width = 5 => '   -2'
-  // but not if filler = '0': width = 5 => '000-2'
+  // Handles negative integers: width = 5 => '   -2', or '-0002' if filler = '0'
   //
-  // https://forum.arduino.cc/t/print-lcd-text-justify-from-right/398351/5
-  // https://forum.arduino.cc/t/u8glib-how-to-display-leading-zeroes/396694/3
-
-  //do we need room for a minus?
-  if (number < 0) {
-    width--;
-  }
-
-  //see how wide the number is
-  if (temp == 0) {
-    width--;
-  }
-  else
-  {
-    while (temp && width) {
-      temp /= 10;
-      width--;
-    }
-  }
-
-  //start by printing the rest of the width with filler symbol
-  while (width) {
-    out.print(filler);
-    width--;
-  }
+  // Formatted by FmtInt() in clock_format.h, use that directly to build a whole line in textBuffer
 
-  out.print(number); // finally print signed number
+  char field[12];
+  FmtInt(field, number, width, filler);
+  out.print(field);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -528,7 +501,7 @@ void LcdUTCTimeLocator(int lineno, int col=0)
 
 //  if (gps.time.isValid()) {
     lcd.setCursor(min(max(col,0),1), lineno);
-    sprintf(textBuffer, "%02d%c%02d%c%02d UTC ", hour(now()), dateTimeFormat[dateFormat].hourSep, minute(now()), dateTimeFormat[dateFormat].minSep, second(now()));
+    FmtText(FmtTime(textBuffer, hour(now()), minute(now()), second(now())), " UTC ");
     lcd.print(textBuffer);
 //  }
 
@@ -553,34 +526,9 @@ void LcdUTCTimeLocator(int lineno, int col=0)
 
 void LcdDate(int Day, int Month, int Year=0) // print date, either day-month or day-month-year according to specified format
 {
-  if (dateTimeFormat[dateFormat].dateOrder == 'B')
-    {
-      if (Year !=0) 
-      { 
-        PrintFixedWidth(lcd, Year, 4); lcd.print(dateTimeFormat[dateFormat].dateSep);
-      }
-      PrintFixedWidth(lcd, Month, 2, '0'); lcd.print(dateTimeFormat[dateFormat].dateSep);
-      PrintFixedWidth(lcd, Day, 2, '0');
-    }
-    else if (dateTimeFormat[dateFormat].dateOrder == 'M')
-    {
-      PrintFixedWidth(lcd, Month, 2, '0'); lcd.print(dateTimeFormat[dateFormat].dateSep);
-      PrintFixedWidth(lcd, Day, 2, '0'); 
-      if (Year !=0) 
-      {
-        lcd.print(dateTimeFormat[dateFormat].dateSep);PrintFixedWidth(lcd, Year, 4);
-      }
-    }
-    else
-    {
-      PrintFixedWidth(lcd, Day, 2, '0'); lcd.print(dateTimeFormat[dateFormat].dateSep);
-      PrintFixedWidth(lcd, Month, 2, '0'); 
-      if (Year !=0) 
-      {
-        lcd.print(dateTimeFormat[dateFormat].dateSep);PrintFixedWidth(lcd, Year, 4);
-      }
-    }
-  
+  char date[12];
+  FmtDate(date, Day, Month, Year);  // clock_format.h
+  lcd.print(date);
 }
 
 
@@ -606,10 +554,10 @@ void LcdShortDayDateTimeLocal(int lineno = 0, int moveLeft = 0) {
         nativeDayLong(localTime);
         // 17.05.2023:
         if     (strcmp(languages[languageNumber],"de ") == 0)  
-                sprintf(textBuffer,"%2.2s",today);  // 2 letters for day name in German
+                FmtText(textBuffer, today, 2, 2);  // 2 letters for day name in German
         else if (strcmp(languages[languageNumber],"nl ") == 0) 
-                sprintf(textBuffer,"%2.2s.",today);  // 2 letters + dot Dutch 
-        else    sprintf(textBuffer,"%3.3s",today);  // else 3 letters
+                FmtText(FmtText(textBuffer, today, 2, 2), ".");  // 2 letters + dot Dutch 
+        else    FmtText(textBuffer, today, 3, 3);  // else 3 letters
         lcd.print(textBuffer);
 
         lcd.setCursor(4, lineno);
@@ -630,7 +578,7 @@ void LcdShortDayDateTimeLocal(int lineno = 0, int moveLeft = 0) {
       }
       lcd.print(F("    ")); // in order to erase remnants of long string as the month changes
       lcd.setCursor(11 - moveLeft, lineno);
-      sprintf(textBuffer, " %02d%c%02d%c%02d", Hour, dateTimeFormat[dateFormat].hourSep, Minute, dateTimeFormat[dateFormat].minSep, Seconds); // corrected 18.10.2021
+      FmtTime(FmtText(textBuffer, " "), Hour, Minute, Seconds); // corrected 18.10.2021
       lcd.print(textBuffer);
     }
 
@@ -649,12 +597,6 @@ void LcdSolarRiseSet(
   double transit, sunrise, sunset;  // time in utc hours of events  
   int m, hr, mn;                    // time in hr, mn local time
   
-  #ifdef FEATURE_DATE_PER_SECOND  // for stepping date quickly and check calender function   
-    // check June when sun hardly sets
-    //monthGPS = 6;
-    dayGPS =  dateIteration;
-    dateIteration = dateIteration + 1;
-  #endif
   // https://www.timeanddate.com/astronomy/different-types-twilight.html
   if (RiseSetDefinition == 'A')     // astronomical: -18 deg
   // "During astronomical twilight, most celestial objects can be observed in the sky. However, the atmosphere still scatters and 
@@ -1171,8 +1113,8 @@ void LCDPlanetData(float altitudePlanet, float azimuthPlanet, float phase, float
     lcd.print(" "); PrintFixedWidth(lcd, (int)round(100*phase), 3); lcd.print(" "); 
     if (magnitude >=0) {lcd.print("+");} // instead of minus sign
     
-    if (abs(magnitude) < 10)  lcd.print(String(magnitude, 1));
-    else                      lcd.print(String(magnitude, 0)); 
+    FmtFixed(textBuffer, magnitude, 0, abs(magnitude) < 10 ? 1 : 0);
+    lcd.print(textBuffer);
                   
 }
 
@@ -1232,7 +1174,7 @@ void LCDChemicalElementName(int ElementNo) {
     if (strcmp(languages[languageNumber],"nb ")==0 ||strcmp(languages[languageNumber],"nn ")==0) 
       if (ElementNo == 47) 
       {
-        strcpy(textBuffer,"Solv      "); textBuffer[1] = char(NO_DA_oe_SMALL); // sølv
+        TextUtf8(textBuffer, "Sølv      ");  // ø is a custom character
       }        
       else strncpy_P(textBuffer, ElementNavn[ElementNo - 1], 12);    // Norwegian
       
@@ -1350,7 +1292,7 @@ while ((menuStruct[subsetMenu].order[noOfStates] >= 0) && (noOfStates <= lengthO
     noOfStates = noOfStates + 1;  
 
   // initialize and unroll menu system order
-  for (iiii = 0; iiii < sizeof(menuOrder)/sizeof(menuOrder[0]); iiii += 1) menuOrder[iiii] = -1; // fix 5.10.2022
+  for (iiii = 0; iiii < sizeof(menuOrder)/sizeof(menuOrder[0]); iiii += 1) menuOrder[iiii] = MENU_NONE; // fix 5.10.2022
   for (iiii = 0; iiii < noOfStates; iiii += 1) menuOrder[menuStruct[subsetMenu].order[iiii]] = iiii;
 }
 
@@ -1516,7 +1458,7 @@ case 0: // GPS baud rate //////////////
 case 3: // demo step type as DemoClock cycles through all screen //////////////
  {
   demoStepType = EEPROM.read(EEPROM_OFFSET1+10);  
-  lcd.setCursor(0,2); lcd.print(F("Demo step:")); lcd.print(F("       "));
+  lcd.setCursor(0,2); lcd.print(F("Demo step:")); lcd.print(F("        "));
   lcd.setCursor(11,2); lcd.print(demoStepTypeText[demoStepType]);
   startTime = millis();
   while (toggleInternRotary == 0)
@@ -1530,7 +1472,7 @@ case 3: // demo step type as DemoClock cycles through all screen //////////////
       else if (rotaryResult == r.clockwise()){               // increase  value
         demoStepType = demoStepType + 1; if (demoStepType > 2) demoStepType = demoStepType - 3;
       }
-    lcd.setCursor(0,2); lcd.print(F("Demo step:")); lcd.print(F("       "));
+    lcd.setCursor(0,2); lcd.print(F("Demo step:")); lcd.print(F("        "));
     lcd.setCursor(11,2); lcd.print(demoStepTypeText[demoStepType]);
     startTime = millis();  // reset counter if rotary is moved
     }
@@ -1850,7 +1792,7 @@ case 2: // 2222222222 date format ////////////////
   
   lcd.setCursor(0,1); lcd.print((char)(97+dateFormat)); lcd.print(F(". "));lcd.print(dateTimeFormat[dateFormat].descr);
   lcd.setCursor(0,3); LcdDate(Day, Month, Year);
-  sprintf(textBuffer, " %02d%c%02d%c%02d", Hour, dateTimeFormat[dateFormat].hourSep, Minute, dateTimeFormat[dateFormat].minSep, Seconds);
+  FmtTime(FmtText(textBuffer, " "), Hour, Minute, Seconds);
   lcd.print(textBuffer);
   
   int noOfMenuIn = sizeof(dateTimeFormat)/sizeof(dateTimeFormat[0]);
@@ -1872,7 +1814,7 @@ case 2: // 2222222222 date format ////////////////
 
       lcd.setCursor(0,1); lcd.print((char)(97+dateFormat)); lcd.print(F(". "));lcd.print(dateTimeFormat[dateFormat].descr);
       lcd.setCursor(0,3); LcdDate(Day, Month, Year);
-      sprintf(textBuffer, " %02d%c%02d%c%02d", Hour, dateTimeFormat[dateFormat].hourSep, Minute, dateTimeFormat[dateFormat].minSep, Seconds);
+      FmtTime(FmtText(textBuffer, " "), Hour, Minute, Seconds);
       lcd.print(textBuffer);
 
       //lcd.print(dateTimeFormat[dateFormat].dateOrder);  PrintFixedWidth(lcd, dateFormat, 3);
@@ -1914,7 +1856,7 @@ case 3: // 333333333 time zone /////////////////////////////////////////
   lcd.setCursor(9,3); lcd.print(F("UTC"));
   utcOffset = localTime / long(60) - utc / long(60); // order of calculation is important 
   if (utcOffset >=0)  lcd.print("+");
-  lcd.print(float(utcOffset)/60); lcd.print(F("  "));
+  FmtFixed(textBuffer, float(utcOffset)/60, 0, 2); lcd.print(textBuffer); lcd.print(F("  "));
 
   int firstZone = 0;// 1;// 0; first index used in tcr and local: only !=0 for debugging
   
@@ -1945,7 +1887,7 @@ case 3: // 333333333 time zone /////////////////////////////////////////
       utcOffset = localTime / long(60) - utc / long(60); // order of calculation is important
       lcd.setCursor(9,3); lcd.print(F("UTC")); 
       if (utcOffset >=0)  lcd.print("+");
-      lcd.print(float(utcOffset)/60); lcd.print(F("  "));
+      FmtFixed(textBuffer, float(utcOffset)/60, 0, 2); lcd.print(textBuffer); lcd.print(F("  "));
   
       startTime = millis();  // reset counter if rotary is moved
     } 
@@ -1976,7 +1918,7 @@ case 3: // 333333333 time zone /////////////////////////////////////////
   lcd.print((char)(97+languageNumber));lcd.print(F(". "));lcd.print(languages[languageNumber]);     
    
   nativeDayLong(localTime);
-  sprintf(todayFormatted,"%-12s", today);
+  FmtText(todayFormatted, today, -12);
   lcd.setCursor(5,3); lcd.print(todayFormatted);
 
   while (toggleInternRotary == 1)
@@ -1995,10 +1937,9 @@ case 3: // 333333333 time zone /////////////////////////////////////////
      
       lcd.setCursor(0,1);lcd.print((char)(97+languageNumber));lcd.print(F(". "));  // OK
       lcd.print(languages[languageNumber]);
-      loadNativeCharacters(languageNumber);  // reload user-defined characters for native languages
       
       nativeDayLong(localTime);
-      sprintf(todayFormatted,"%-12s", today);
+      FmtText(todayFormatted, today, -12);
       lcd.setCursor(5,3);; lcd.print(todayFormatted);
 
       startTime = millis();  // reset counter if rotary is moved
@@ -2194,23 +2135,15 @@ const byte downDashedArray[8] PROGMEM = {0x4, 0x0, 0x4, 0x0, 0x15, 0xa, 0x4, 0x0
 const byte upArray[8]         PROGMEM = {0x4, 0xe, 0x15, 0x4, 0x4, 0x4, 0x4, 0x0};
 const byte downArray[8]       PROGMEM = {0x4, 0x4, 0x4, 0x4, 0x15, 0xe, 0x4, 0x0};
 
+const LcdGlyph arrowGlyphs[] PROGMEM = {
+  {DASHED_UP_ARROW, upDashedArray}, {DASHED_DOWN_ARROW, downDashedArray}, {UP_ARROW, upArray}, {DOWN_ARROW, downArray}};
+
 void loadArrowCharacters()
 {
-  if (LCDchar0_3 != LCDARROWS)
+  if (lcd.glyphs(GLYPH_SET(arrowGlyphs)))  // only those not already in the LCD are uploaded
   {
-  // upload characters to the lcd
-  memcpy_P(buffer,upDashedArray, 8);
-  lcd.createChar(DASHED_UP_ARROW, buffer);
-  memcpy_P(buffer,downDashedArray, 8);
-  lcd.createChar(DASHED_DOWN_ARROW, buffer);
-  memcpy_P(buffer,upArray, 8);
-  lcd.createChar(UP_ARROW, buffer);
-  memcpy_P(buffer,downArray, 8); 
-  lcd.createChar((byte)DOWN_ARROW, buffer);
   lcd.clear();  // in order to set the LCD back to the proper memory mode after custom characters have been created
 
-  LCDchar0_3 = LCDARROWS;
-  
   #ifdef FEATURE_SERIAL_LOAD_CHARACTERS
      Serial.println(F("loadArrowCharacters"));
   #endif
@@ -2263,24 +2196,16 @@ const byte fourFilled[8] PROGMEM = {
   B11110
 };
 
+const LcdGlyph simpleBarGlyphs[] PROGMEM = {
+  {ONE_BAR, oneFilled}, {TWO_BARS, twoFilled}, {THREE_BARS, threeFilled}, {FOUR_BARS, fourFilled}};
+
 void loadSimpleBarCharacters()
 {
 
-  if (LCDchar0_3 != LCDBARS)
+  if (lcd.glyphs(GLYPH_SET(simpleBarGlyphs)))
   {
-    // upload characters to the lcd
-      memcpy_P(buffer,oneFilled, 8);
-      lcd.createChar(ONE_BAR, buffer);
-      memcpy_P(buffer,twoFilled, 8);
-      lcd.createChar(TWO_BARS, buffer);
-      memcpy_P(buffer,threeFilled, 8);
-      lcd.createChar(THREE_BARS, buffer);
-      memcpy_P(buffer,fourFilled, 8);
-      lcd.createChar(FOUR_BARS, buffer);
       lcd.clear();  // in order to set the LCD back to the proper memory mode after custom characters have been created
 
-      LCDchar0_3 = LCDBARS;
-
       #ifdef FEATURE_SERIAL_LOAD_CHARACTERS
         Serial.println(F("loadSimpleBarCharacters"));
       #endif
@@ -2390,208 +2315,40 @@ const byte LMB[8] PROGMEM =
   B11111
 };
 
+// assignes each segment a write number
+const LcdGlyph threeWideGlyphs[] PROGMEM = {
+  {0, LT}, {1, UB}, {2, RT}, {3, LL}, {4, LB}, {5, LR}, {6, UMB}, {7, LMB}};
+
 void loadThreeWideDigits()
 // https://forum.arduino.cc/t/large-alphanumeric-on-lcd/8946/3
 {
 
-  if (LCDchar0_3 != LCD3WIDE || LCDchar4_5 != LCD3WIDE || LCDchar6_7 != LCD3WIDE)
+  if (lcd.glyphs(GLYPH_SET(threeWideGlyphs)))
   {
-
-    // assignes each segment a write number
-    memcpy_P(buffer,LT, 8);
-    lcd.createChar((byte)0 , buffer);
-    memcpy_P(buffer,UB, 8);
-    lcd.createChar(1 , buffer);
-    memcpy_P(buffer,RT, 8);
-    lcd.createChar(2 , buffer);
-    memcpy_P(buffer,LL, 8);
-    lcd.createChar(3 , buffer);
-    memcpy_P(buffer,LB, 8);
-    lcd.createChar(4 , buffer);
-    memcpy_P(buffer,LR, 8);
-    lcd.createChar(5 , buffer);
-    memcpy_P(buffer,UMB, 8);
-    lcd.createChar(6 , buffer);
-    memcpy_P(buffer,LMB, 8);
-    lcd.createChar(7 , buffer);
     lcd.clear();  // in order to set the LCD back to the proper memory mode after custom characters have been created
 
-    LCDchar0_3 = LCD3WIDE;
-    LCDchar4_5 = LCD3WIDE;
-    LCDchar6_7 = LCD3WIDE;
-
     #ifdef FEATURE_SERIAL_LOAD_CHARACTERS
             Serial.println(F("loadThreeWideDigits"));
     #endif
   }
 }
 
-// position in display
-int x = 0;
-int y = 0;
-
-///////////////////////////////////////////////////////
-
-void custom0()
-{ // uses segments to build the number 0
-  lcd.setCursor(x, y); // set cursor to column 0, line 0 (first row)
-  lcd.write(byte(0));  // call each segment to create
-  lcd.write(byte(1));  // top half of the number
-  lcd.write(byte(2));
-  lcd.setCursor(x, y+1); // set cursor to colum 0, line 1 (second row)
-  lcd.write(byte(3));  // call each segment to create
-  lcd.write(byte(4));  // bottom half of the number
-  lcd.write(byte(5));
-}
-
-void custom1()
-{
-  lcd.setCursor(x,y+0);
-  //lcd.write(byte(1)); // 25.10.2023
-  lcd.write(ALL_OFF);
-  //lcd.write(byte(2)); // 25.10.2023
-  lcd.write(byte(0));
-  lcd.write(ALL_OFF);
-  lcd.setCursor(x,y+1);
-  lcd.write(ALL_OFF);
-  lcd.write(byte(5));
-  lcd.write(ALL_OFF);
-}
-
-void custom2()
-{
-  lcd.setCursor(x,y);
-  lcd.write(byte(6));
-  lcd.write(byte(6));
-  lcd.write(byte(2));
-  lcd.setCursor(x, y+1);
-  lcd.write(byte(3));
-  lcd.write(byte(7));
-  lcd.write(byte(7));
-}
-
-void custom3()
-{
-  lcd.setCursor(x,y);
-  lcd.write(byte(6));
-  lcd.write(byte(6));
-  lcd.write(byte(2));
-  lcd.setCursor(x, y+1);
-  lcd.write(byte(7));
-  lcd.write(byte(7));
-  lcd.write(byte(5)); 
-}
-
-void custom4()
-{
-  lcd.setCursor(x,y);
-  lcd.write(byte(3));
-  lcd.write(byte(4));
-  lcd.write(byte(2));
-  lcd.setCursor(x, y+1);
-  lcd.write(ALL_OFF);
-  lcd.write(ALL_OFF);
-  lcd.write(byte(5));
-}
-
-void custom5()
-{
-  lcd.setCursor(x,y);
-  lcd.write(byte(0));
-  lcd.write(byte(6));
-  lcd.write(byte(6));
-  lcd.setCursor(x, y+1);
-  lcd.write(byte(7));
-  lcd.write(byte(7));
-  lcd.write(byte(5));
-}
-
-void custom6()
-{
-  lcd.setCursor(x,y);
-  lcd.write(byte(0));
-  lcd.write(byte(6));
-  lcd.write(byte(6));
-  lcd.setCursor(x, y+1);
-  lcd.write(byte(3));
-  lcd.write(byte(7));
-  lcd.write(byte(5));
-}
-
-void custom7()
-{
-  lcd.setCursor(x,y);
-  lcd.write(byte(1));
-  lcd.write(byte(1));
-  lcd.write(byte(2));
-  lcd.setCursor(x,y+1);
-  lcd.write(ALL_OFF);
-  lcd.write(byte(0));
-  lcd.write(ALL_OFF);
-}
-
-void custom8()
-{
-  lcd.setCursor(x,y);
-  lcd.write(byte(0));
-  lcd.write(byte(6));
-  lcd.write(byte(2));
-  lcd.setCursor(x,y+1);
-  lcd.write(byte(3));
-  lcd.write(byte(7));
-  lcd.write(byte(5));
-}
-
-void custom9()
-{
-  lcd.setCursor(x,y);
-  lcd.write(byte(0));
-  lcd.write(byte(6));
-  lcd.write(byte(2));
-  lcd.setCursor(x, y+1);
-  lcd.write(ALL_OFF);
-  lcd.write(ALL_OFF);
-  lcd.write(byte(5));
-}
-
-void draw_digit(byte digit, byte xpos, byte ypos)
-// three width wide digits
-{
-  x = xpos;
-  y = ypos;
-  switch (digit) {
-  case 0:
-    custom0();
-    break;
-  case 1:
-    custom1();
-    break;
-  case 2:
-    custom2();
-    break;
-  case 3:
-    custom3();
-    break;
-  case 4:
-    custom4();
-    break;
-  case 5:
-    custom5();
-    break;
-  case 6:
-    custom6();
-    break;
-  case 7:
-    custom7();
-    break;
-  case 8:
-    custom8();
-    break;
-  case 9:
-    custom9();
-    break;
-  }
-}
+// cells of each digit, top row first, as characters for the display: slots of threeWideGlyphs, or blank
+#define BW ALL_OFF
+const uint8_t threeWideCells[10][6] PROGMEM = {
+  {0, 1, 2,   3, 4, 5},     // 0
+  {BW, 0, BW, BW, 5, BW},   // 1
+  {6, 6, 2,   3, 7, 7},     // 2
+  {6, 6, 2,   7, 7, 5},     // 3
+  {3, 4, 2,   BW, BW, 5},   // 4
+  {0, 6, 6,   7, 7, 5},     // 5
+  {0, 6, 6,   3, 7, 5},     // 6
+  {1, 1, 2,   BW, 0, BW},   // 7
+  {0, 6, 2,   3, 7, 5},     // 8
+  {0, 6, 2,   BW, BW, 5}};  // 9
+#undef BW
+
+const BigDigitStyle threeWideDigits = {3, 2, &threeWideCells[0][0]};
 
 ////////////////////////////////////////////////////////////////
 // 2x3 numbers variant 2 with space in second half of character below
@@ -2675,31 +2432,16 @@ const byte c6[8] PROGMEM =  // colon
 };
 
 /////////////////////////////////
+const LcdGlyph threeHighGlyphs[] PROGMEM = {  // digit pieces
+  {0, c0}, {1, c1}, {2, c2}, {3, c3}, {4, c4}, {5, c5}, {6, c6}};
+
 void loadThreeHighDigits2()
 {
 
-  if (LCDchar0_3 != LCD3HIGH || LCDchar4_5 != LCD3HIGH || LCDchar6_7 != LCD3HIGH)
+  if (lcd.glyphs(GLYPH_SET(threeHighGlyphs)))
   {
-    memcpy_P(buffer,c0, 8);
-    lcd.createChar((byte)0, buffer);                      // digit piece
-    memcpy_P(buffer,c1, 8);
-    lcd.createChar(1, buffer);                      // digit piece
-    memcpy_P(buffer,c2, 8);
-    lcd.createChar(2, buffer);                      // digit piece
-    memcpy_P(buffer,c3, 8);
-    lcd.createChar(3, buffer);                      // digit piece
-    memcpy_P(buffer,c4, 8);
-    lcd.createChar(4, buffer);                      // digit piece
-    memcpy_P(buffer,c5, 8);
-    lcd.createChar(5, buffer);                      // digit piece
-    memcpy_P(buffer,c6, 8);
-    lcd.createChar(6, buffer);                      // digit piece
     lcd.clear();  // in order to set the LCD back to the proper memory mode after custom characters have been created
 
-    LCDchar0_3 = LCD3HIGH;
-    LCDchar4_5 = LCD3HIGH;
-    LCDchar6_7 = LCD3HIGH;
-
     #ifdef FEATURE_SERIAL_LOAD_CHARACTERS
         Serial.println(F("loadThreeHighDigits2"));
     #endif
@@ -2707,55 +2449,22 @@ void loadThreeHighDigits2()
 
 }
 
-////////////////////////////////////////////////////////
-void doNumber2(byte num, byte r, byte c) {
-    lcd.setCursor(c,r);
-    switch(num) {
-      case 0: lcd.write(byte(4)); lcd.write(byte(3)); 
-              lcd.setCursor(c,r+1); lcd.write(byte(1)); lcd.write(byte(5)); 
-              lcd.setCursor(c,r+2); lcd.write(byte(2)); lcd.write(byte(2)); break;
-            
-      case 1: lcd.write(byte(0)); lcd.write(byte(1)); 
-              lcd.setCursor(c,r+1); lcd.print(" "); lcd.write(byte(1));
-              lcd.setCursor(c,r+2); lcd.write(byte(0)); lcd.write(byte(2)); break;
-            
-      case 2: lcd.write(byte(2)); lcd.write(byte(3)); 
-              lcd.setCursor(c,r+1); lcd.write(byte(4)); lcd.write(byte(2)); 
-              lcd.setCursor(c,r+2); lcd.write(byte(2)); lcd.write(byte(2)); break;  
-            
-      case 3: lcd.write(byte(2)); lcd.write(byte(3)); 
-              lcd.setCursor(c,r+1); lcd.write(byte(0)); lcd.write(byte(3)); 
-              lcd.setCursor(c,r+2); lcd.write(byte(2)); lcd.write(byte(2)); break;  
-              
-            
-      case 4: lcd.write(byte(1)); lcd.write(byte(5)); 
-              lcd.setCursor(c,r+1); lcd.write(byte(2)); lcd.write(byte(3)); 
-              lcd.setCursor(c,r+2); lcd.print(" "); lcd.write(byte(0)); break;  
-            
-      case 5: lcd.write(byte(4)); lcd.write(byte(2)); 
-              lcd.setCursor(c,r+1); lcd.write(byte(2)); lcd.write(byte(3)); 
-              lcd.setCursor(c,r+2); lcd.write(byte(2)); lcd.write(byte(2)); break; 
-
-      case 6: lcd.write(byte(1)); lcd.print(" ");     
-              lcd.setCursor(c,r+1); lcd.write(byte(4)); lcd.write(byte(3)); 
-              lcd.setCursor(c,r+2); lcd.write(byte(2)); lcd.write(byte(2)); break;  
-
-      case 7: lcd.write(byte(2)); lcd.write(byte(3));
-              lcd.setCursor(c,r+1); lcd.print(" "); lcd.write(byte(5)); 
-              lcd.setCursor(c,r+2); lcd.print(" ");  lcd.write(byte(0)); break;  
-
-      case 8: lcd.write(byte(4)); lcd.write(byte(3)); 
-              lcd.setCursor(c,r+1); lcd.write(byte(4)); lcd.write(byte(3)); 
-              lcd.setCursor(c,r+2); lcd.write(byte(2)); lcd.write(byte(2)); break;  
-   
-      case 9: lcd.write(byte(4)); lcd.write(byte(3)); 
-              lcd.setCursor(c,r+1); lcd.write(byte(2)); lcd.write(byte(3)); 
-              lcd.setCursor(c,r+2);  lcd.print(" "); lcd.write(byte(0)); break;  
+// cells of each digit, top row first, as characters for the display: slots of threeHighGlyphs, or blank
+const uint8_t threeHighCells[10][6] PROGMEM = {
+  {4, 3,     1, 5,     2, 2},     // 0
+  {0, 1,     ' ', 1,   0, 2},     // 1
+  {2, 3,     4, 2,     2, 2},     // 2
+  {2, 3,     0, 3,     2, 2},     // 3
+  {1, 5,     2, 3,     ' ', 0},   // 4
+  {4, 2,     2, 3,     2, 2},     // 5
+  {1, ' ',   4, 3,     2, 2},     // 6
+  {2, 3,     ' ', 5,   ' ', 0},   // 7
+  {4, 3,     4, 3,     2, 2},     // 8
+  {4, 3,     2, 3,     ' ', 0}};  // 9
 
-       case 11: lcd.setCursor(c,r); lcd.write(byte(6));       // colon
-                lcd.setCursor(c,r+1); lcd.write(byte(6)); break; 
-    } 
-}
+const BigDigitStyle threeHighDigits = {2, 3, &threeHighCells[0][0]};
+
+#define BIG_COLON 6  // slot of the colon in threeHighGlyphs, one character in each of the two upper rows
 
 
 // Progress bar with every other vertical line filled, 
@@ -2821,31 +2530,18 @@ byte filled;
 byte empty;
 
 //////////////////////////////////////////////////////////
+const LcdGlyph gapLessGlyphs[] PROGMEM = {
+  {0, g70}, {1, g71}, {2, g72}, {3, g73}, {4, g74}, {5, g75}};
+
 void loadGapLessCharacters7A()
 {
-  // same as loadGapLessCharacters7(), except initial test whether loaded previously
+  // same as loadGapLessCharacters7(), except that only characters not already in the LCD are uploaded
+  filled = 2;
+  empty = 3;
 
-  if (LCDchar0_3 != LCDGAPLESS || LCDchar4_5 != LCDGAPLESS || LCDchar6_7 != LCDGAPLESS) // more conditions 31.10.2024
+  if (lcd.glyphs(GLYPH_SET(gapLessGlyphs)))
   {
-    memcpy_P(buffer,g70, 8);
-    lcd.createChar((byte)0, buffer);
-    memcpy_P(buffer,g71, 8);
-    lcd.createChar(1, buffer);
-    memcpy_P(buffer,g72, 8);
-    lcd.createChar(2, buffer);
-    memcpy_P(buffer,g73, 8);
-    lcd.createChar(3, buffer);
-    memcpy_P(buffer,g74, 8);
-    lcd.createChar(4, buffer);
-    memcpy_P(buffer,g75, 8);
-    lcd.createChar(5, buffer);
     lcd.clear();  // in order to set the LCD back to the proper memory mode after custom characters have been created
-    filled = 2;
-    empty = 3;
-
-    LCDchar0_3 = LCDGAPLESS;
-    LCDchar4_5 = LCDGAPLESS;
-    LCDchar6_7 = LCDGAPLESS;
 
     #ifdef FEATURE_SERIAL_LOAD_CHARACTERS
       Serial.println(F("loadGapLessCharacters7"));
@@ -3271,33 +2967,13 @@ const byte end1[8] PROGMEM = {
   B10000
 };
 
+const LcdGlyph curvedFramedBarGlyphs[] PROGMEM = {  // empty = 0, filled = 5
+  {0, zeroBar}, {1, oneBar}, {2, twoBar}, {3, threeBar}, {4, fourBar}, {5, fiveBar}, {6, beg1}, {7, end1}};
+
 void loadCurvedFramedBarCharactersA() {  // Bar 5, ( xxxx )
   empty = 0;
   filled = 5;
-  if (LCDchar0_3 != LCDFRAMEDBARS || LCDchar4_5 != LCDFRAMEDBARS || LCDchar6_7 != LCDFRAMEDBARS) 
- {
-    memcpy_P(buffer,zeroBar, 8);
-    lcd.createChar(empty, buffer);
-    memcpy_P(buffer,oneBar, 8);
-    lcd.createChar(1, buffer);
-    memcpy_P(buffer,twoBar, 8);
-    lcd.createChar(2, buffer);
-    memcpy_P(buffer,threeBar, 8);
-    lcd.createChar(3, buffer);
-    memcpy_P(buffer,fourBar, 8);
-    lcd.createChar(4, buffer);
-    memcpy_P(buffer,fiveBar, 8);
-    lcd.createChar(filled, buffer);
-
-    memcpy_P(buffer,beg1, 8);
-    lcd.createChar(6, buffer);
-    memcpy_P(buffer,end1, 8);
-    lcd.createChar(7, buffer);
-
-    LCDchar0_3 = LCDFRAMEDBARS; 
-    LCDchar4_5 = LCDFRAMEDBARS;
-    LCDchar6_7 = LCDFRAMEDBARS;
- }
+  lcd.glyphs(GLYPH_SET(curvedFramedBarGlyphs));
 }
 
  /// THE END ///
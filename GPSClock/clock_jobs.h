@@ -0,0 +1,153 @@
+// Resumable computations: the expensive part of a face as a job, advanced in slices of a few ms from loop()
+
+/*
+JobKey
+JobStep
+JobDone
+JobReady
+JobsRun
+ */
+
+// A job is a state machine: its step function does one bounded piece of the work per call, e.g. one pass of an
+// iteration, and keeps what it needs between calls in its own variables. Stage = 0, 1, 2... is the no of the call.
+// JobsRun(), a task of loop() (clock_tasks.h), calls the steps of the running jobs in turn, one step each, until
+// JOB_SLICE_US has been used, so that a long job doesn't hold up the others. The last step publishes the result and returns true; the face draws it when faceRecompute is set,
+// which CadenceBegin() does after each publish. Until then a face shows its last result if the job keeps a copy of
+// it, or a placeholder.
+//
+// key = the inputs the job is computed for, e.g. the day and the position, see JobKey(). A face asks for the result
+// with JobReady(); a different key restarts the job, so a result is never published for inputs which have changed.
+// With jobsAtOnce (benchmark and golden frames) a job is run to the end at once, and also if more than JOBS_MAX jobs
+// would be running, which doesn't happen as long as JOBS_MAX is the no of jobs, as a job is never listed twice
+
+#define JOB_SLICE_US 3000  // time per pass of loop() for the steps of the running jobs
+#define JOBS_MAX     5     // jobs running at the same time: all of them, moon rise/set, eclipses, planets x 2, Hebrew
+
+#define JOB_IDLE    0  // not started, or restarted for a new key
+#define JOB_RUNNING 1
+#define JOB_DONE    2  // result published for key
+
+struct Job
+{
+  boolean (*step)(uint16_t stage);  // returns true when the result has been published
+  uint32_t key;
+  uint16_t stage;                   // next step, stays at 65535 rather than wrapping to 0
+  uint8_t state;                    // JOB_IDLE, JOB_RUNNING, JOB_DONE
+  boolean valid;                    // a result has been published, possibly for an earlier key
+};
+
+Job *jobsRunning[JOBS_MAX];  // oldest first
+uint8_t jobsCount = 0;
+uint8_t jobsNext = 0;          // index in jobsRunning of the one to step next
+boolean jobPublished = false;  // set when a job is done, cleared by CadenceBegin()
+boolean jobsAtOnce = false;    // run jobs to the end when asked for, for measurements
+
+/*****
+Purpose:
+Combines an input of a job into its key
+
+Argument List: uint32_t key = the inputs so far, start with 0
+               long value = next input, e.g. latitude in 1/100 degree
+
+Return value: uint32_t new key
+*****/
+
+uint32_t JobKey(uint32_t key, long value)
+{
+  return 31 * key + uint32_t(value);
+}
+
+/*****
+Purpose:
+Runs the next step of a job
+
+Argument List: Job *job
+
+Return value: true when the result has been published
+*****/
+
+boolean JobStep(Job *job)
+{
+  uint16_t stage = job->stage;
+  if (job->stage < 65535) job->stage += 1;  // a step function which restarts on stage 0 must not see it again
+  return job->step(stage);
+}
+
+/*****
+Purpose:
+Marks a job as done, and takes it out of the list of running jobs
+
+Argument List: Job *job
+
+Return value: None
+*****/
+
+void JobDone(Job *job)
+{
+  job->state = JOB_DONE;
+  job->valid = true;
+  for (uint8_t i = 0; i < jobsCount; i++)
+    if (jobsRunning[i] == job)
+    {
+      jobsCount -= 1;
+      if (jobsNext > i) jobsNext -= 1;  // the same job is stepped next
+      for (; i < jobsCount; i++) jobsRunning[i] = jobsRunning[i + 1];
+    }
+}
+
+/*****
+Purpose:
+Asks for the result of a job for given inputs, and starts the job if it hasn't been done for them
+
+Argument List: Job *job
+               uint32_t key = the inputs, see JobKey()
+
+Return value: true if the result for key has been published
+*****/
+
+boolean JobReady(Job *job, uint32_t key)
+{
+  if (job->key == key && job->state != JOB_IDLE && !(jobsAtOnce && job->state == JOB_RUNNING))
+    return job->state == JOB_DONE;
+
+  job->key = key;
+  job->stage = 0;
+
+  if (jobsAtOnce || (job->state != JOB_RUNNING && jobsCount >= JOBS_MAX))
+  {
+    while (!JobStep(job)) yield();
+    JobDone(job);
+    return true;
+  }
+
+  if (job->state != JOB_RUNNING) jobsRunning[jobsCount++] = job;
+  job->state = JOB_RUNNING;
+  return false;
+}
+
+/*****
+Purpose:
+Task of loop(): runs steps of the running jobs, one of each in turn, for about JOB_SLICE_US
+
+Argument List: None
+
+Return value: None
+*****/
+
+void JobsRun()
+{
+  uint32_t start = micros();
+  while ((jobsCount > 0) && (micros() - start < JOB_SLICE_US))
+  {
+    if (jobsNext >= jobsCount) jobsNext = 0;
+    Job *job = jobsRunning[jobsNext];
+    if (JobStep(job))
+    {
+      JobDone(job);  // the next one moves into its place
+      jobPublished = true;
+    }
+    else jobsNext += 1;
+  }
+}
+
+// THE END /////
@@ -1,112 +1,28 @@
 // Routines that define letters and language dependent routines
 
 /*
+TextCharacter
+TextUtf8
+TextUtf8_P
+LcdPrintUtf8
 dayName
 nativeDayLong
-loadNativeCharacters
 WordClockNorwegian
  */
 
-// user defined characters, #1-4 are already used in main code (for arrows etc), so numbers start with 5:
+// Text in native languages, e.g. day names in myDays[] (clock_options.h), is written in UTF-8 and transcoded to
+// character codes for the LCD: ASCII as it is, letters which exist in the LCD's character ROM (A00) to their ROM code,
+// and other letters to a custom character from textGlyphs[] below. The custom characters are put in CGRAM slots
+// TEXT_SLOT_FIRST...7 by lcd.glyphSlot() (see clock_lcd.h), which only uploads a bitmap which isn't loaded already, and
+// otherwise replaces the least recently used one. A day name therefore only costs uploads when it has a letter which
+// wasn't on the display before, and then only for that letter.
+//
+// A new language only needs its strings in clock_options.h, and a new letter a line in textGlyphs[] (and a bitmap
+// if it isn't in the ROM). At most 4 different custom letters can be on the display at the same time.
+// Letters not found are shown as TEXT_UNKNOWN
 
-#define SV_DE_oe_SMALL   239  // ö, already exists in LCD memory
-
-// The following def's must match those of LCDchar0_3 etc in *.ino file:
-#define IS_eth_SMALL     4    // ð 
-#define NO_DA_oe_SMALL   5    // ø
-#define IS_THORN_CAPITAL 5    // þ  
-#define ES_e_ACCENT      5    // é  
-#define ES_IS_a_ACCENT   6    // á
-
-#define SCAND_aa_SMALL   6    // å
-#define SCAND_AA_CAPITAL 7    // Å
-
-#define NORSE_o_ACCENT   7    // ó, 10.10.2024
-//#define NORSE_O_ACCENT   7    // Ó, 13.10.2024
-
-#define FO_i_ACCENT 4    // í, 29.10.2024
-#define FO_y_ACCENT 5    // ý, 29.10.2024
-
-
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-void dayName(int dayAddr)   // return day name in correct language in "today", given dayAddr=1...7 (Sunday ... Saturday)
-{
-    memcpy_P(today,myDays[languageNumber][dayAddr], 12);    // put today's day / language into "today"
- 
-// fix odd letters requiring special characters depending on language chosen:
-
-    if (strcmp(languages[languageNumber],"nb ") == 0 || strcmp(languages[languageNumber],"da ") == 0
-     || strcmp(languages[languageNumber],"nn ") == 0)  
-      if (dayAddr==0) today[1] = char(NO_DA_oe_SMALL); // Søndag - Norwegian, Danish, Nynorsk
-
-    if (strcmp(languages[languageNumber],"nb ") == 0 || strcmp(languages[languageNumber],"da ") == 0)
-      if (dayAddr==6) today[1] = char(NO_DA_oe_SMALL); // Lørdag - Norwegian, Danish
-
-    if (strcmp(languages[languageNumber],"es ") == 0)
-    {
-      if (dayAddr==3) today[2] = char(ES_e_ACCENT);    // Miércoles - Spanish
-      if (dayAddr==6) today[1] = char(ES_IS_a_ACCENT); // Sábado - Spanish
-    }
-
-    if (strcmp(languages[languageNumber],"sv ") == 0)
-      if (dayAddr==0 || dayAddr==6) today[1] = char(SV_DE_oe_SMALL); // Söndag, Lördag - Swedish
-
-    if (strcmp(languages[languageNumber],"sv ") == 0 || strcmp(languages[languageNumber],"nn ") == 0)
-      if (dayAddr==1)               today[1] = char(SCAND_aa_SMALL); // Måndag - Swedish, Nynorsk
-
-    if (strcmp(languages[languageNumber],"is ") == 0)
-    {
-      if (dayAddr==1) today[1] = char(ES_IS_a_ACCENT);   // Mánudagur - Icelandic
-      if (dayAddr==2)                                    // þriðjudagur - Icelandic
-      {
-          today[0] = char(IS_THORN_CAPITAL); 
-          today[3] = char(IS_eth_SMALL);     
-      }
-      if (dayAddr==3) today[2] = char(IS_eth_SMALL);     // Miðvikudagur - Icelandic
-      if (dayAddr==5) today[1] = char(SV_DE_oe_SMALL);   // Föstudagu - Icelandic
-    }
-
-    if (strcmp(languages[languageNumber],"non") == 0) // Old Norse, 10.10.2024
-    {
-      if (dayAddr==1) today[1] = char(ES_IS_a_ACCENT);   // Mánudagr - Old Norse 
-      if (dayAddr==3) 
-      {
-       // today[0] = char(NORSE_O_ACCENT);   // Óðinsdagr - If not capital Ó, then O or ó must do
-        today[1] = char(IS_eth_SMALL);     // Óðinsdagr - Old Norse 
-      }
-      if (dayAddr==4)                         // Þórsdagr - Old Norse 
-      {
-        today[0] = char(IS_THORN_CAPITAL); 
-        today[1] = char(NORSE_o_ACCENT); 
-      }
-      if (dayAddr==5) today[3] = char(ES_IS_a_ACCENT);   // Frjádagr - Old Norse 
-    }
-
-    if (strcmp(languages[languageNumber],"fo ") == 0) // Faroese, 29.10.2024
-    {
-      if (dayAddr==1) today[1] = char(ES_IS_a_ACCENT);  // Mánudagur - Faroese
-      if (dayAddr==2) today[1] = char(FO_y_ACCENT);     // Týsdagur - Faroese
-      if (dayAddr==4) today[1] = char(NORSE_o_ACCENT);  // Hósdagur - Faroese
-      if (dayAddr==5) today[2] = char(FO_i_ACCENT);     // Fríggjadagur - Faroese
-    }
-}
-
-/////////////////////////////////////////////////////////////////////////
-
-void nativeDayLong(time_t unixTime) {  // unix time in sec, output through global char array today. Was float, now time_t. Fix 12.10.2024
- //  Full weekday name in native (= non-English language)
- //  Max 12 characters in name
- //  
-
-int dayAddr = weekday(unixTime) - 1; // weekday() = day of the week (1-7), Sunday is day 1
-
-#ifdef FEATURE_DAY_PER_SECOND     //    fake the day -- for testing only
-          dayAddr = second(localTime/2)%7; // change every 2 seconds
-#endif
-
-dayName(dayAddr);
-}
+#define TEXT_SLOT_FIRST  4    // CGRAM slots 4...7 for letters, 0...3 are used for arrows
+#define TEXT_UNKNOWN     '?'
 
 ///////////////////////////////////////////////
 
@@ -124,154 +40,142 @@ const byte eth[8]        PROGMEM = {B01000, B00100, B01110, B10001, B10001, B100
 const byte y_accent[8]   PROGMEM = {B00010, B00100, B10001, B10001, B01111, B00001, B01110, B00000}; // Faroese 
 const byte i_accent[8]   PROGMEM = {B00100, B01000, B01100, B00100, B00100, B00100, B01110, B00000}; // Faroese Fríggjadagur
 //const byte Cedila[8]     PROGMEM = {B00000, B01110, B10000, B10001, B01110, B00100, B01100, B00000}; // for Portugese
-///////////////////////////////////////////////
 
-void loadNativeCharacters(int8_t languageNumber)
+struct TextGlyph
 {
-//  LCD display definitions of special native characters for languages
-//  03.03.2024: Using PROGMEM, only loads the chosen language's character set, no longer for a group of languages
+  uint16_t codePoint;         // Unicode
+  uint8_t  rom;               // code in the LCD's character ROM, 0 = custom character
+  const uint8_t *bitmap;      // 8 bytes in PROGMEM, when rom = 0
+};
 
-//  Norwegian/Danish letters are also used in WordClock, ø: "lørdag, søndag", and Chemical Elements "sølv"
 //  https://forum.arduino.cc/t/error-lcd-16x2/211977/6
+//  https://einhugur.com/blog/index.php/xojo-gpio/hd44780-based-lcd-display/
+const TextGlyph textGlyphs[] PROGMEM = {
+  {0x00E4, 0xE1, NULL},       // ä, in ROM: German, Swedish
+  {0x00F1, 0xEE, NULL},       // ñ
+  {0x00F6, 0xEF, NULL},       // ö
+  {0x00FC, 0xF5, NULL},       // ü
+  {0x00C5, 0, AA_capital},    // Å: Norwegian WordClock "Åtte"
+  {0x00D3, 0, O_accent},      // Ó: Old Norse "Óðinsdagr"
+  {0x00DE, 0, Thorn},         // Þ: Icelandic, Old Norse
+  {0x00E1, 0, a_accent},      // á: Spanish "Sábado", Icelandic, Old Norse, Faroese
+  {0x00E5, 0, AA_small},      // å: Swedish, Nynorsk "Måndag"
+  {0x00E9, 0, e_accent},      // é: Spanish "Miércoles"
+  {0x00ED, 0, i_accent},      // í: Faroese "Fríggjadagur"
+  {0x00F0, 0, eth},           // ð: Icelandic, Old Norse
+  {0x00F3, 0, o_accent},      // ó: Old Norse, Faroese
+  {0x00F8, 0, OE_small},      // ø: Norwegian, Danish "Lørdag", "Søndag"
+  {0x00FD, 0, y_accent},      // ý: Faroese "Týsdagur"
+};
+
+/*****
+Purpose:
+Finds the LCD character code for a Unicode code point, and uploads its custom character if needed
+
+Argument List: uint16_t codePoint
+
+Return value: character code for the LCD
+*****/
+
+char TextCharacter(uint16_t codePoint)
+{
+  if (codePoint < 0x80) return char(codePoint);
 
-if (LCDchar4_5 != LCDNATIVE || LCDchar6_7 != LCDNATIVE || languageNumber != presentLanguageNumber)  // LCDchar6_7 also 5.11.2024
- {
-    if (strcmp(languages[languageNumber],"nb ") == 0 || strcmp(languages[languageNumber],"da ") == 0 
-                                                     || strcmp(languages[languageNumber],"nn ") == 0)
-    {
-        memcpy_P(buffer,OE_small, 8);
-        lcd.createChar(NO_DA_oe_SMALL, buffer);       // ø: "Lørdag", "Søndag"
-    }
+  for (byte i = 0; i < sizeof(textGlyphs) / sizeof(textGlyphs[0]); i++)
+  {
+    if (pgm_read_word(&textGlyphs[i].codePoint) != codePoint) continue;
 
-    if (strcmp(languages[languageNumber],"es ") == 0 || strcmp(languages[languageNumber],"is ") == 0 
-     || strcmp(languages[languageNumber],"non") == 0 || strcmp(languages[languageNumber],"fo ") == 0)
-    {
-        memcpy_P(buffer,a_accent, 8);
-        lcd.createChar(ES_IS_a_ACCENT, buffer);       // á: "Sábado"
-        LCDchar6_7 = LCDNATIVE; // since it fills more than locations 4 and 5 - 30.11.2024
-    }
+    byte rom = pgm_read_byte(&textGlyphs[i].rom);
+    if (rom != 0) return char(rom);
+    return char(lcd.glyphSlot((const uint8_t *)pgm_read_ptr(&textGlyphs[i].bitmap), TEXT_SLOT_FIRST));
+  }
+  return TEXT_UNKNOWN;
+}
 
-    if (strcmp(languages[languageNumber],"sv ") == 0 || strcmp(languages[languageNumber],"nn ") == 0)
-    {
-        // ö exists as char(B11101111) = char(239), no need to create it separately, ä, ü, ñ also
-        memcpy_P(buffer,AA_small, 8);
-        lcd.createChar(SCAND_aa_SMALL, buffer);       //  å: "måndag", Swedish/nynorsk
-        LCDchar6_7 = LCDNATIVE; // since it fills more than locations 4 and 5 - 30.11.2024
-    }
+/*****
+Purpose:
+Transcodes UTF-8 text to LCD character codes, in the same way as the functions of clock_format.h
 
-    if (strcmp(languages[languageNumber],"es ") == 0)
-    {
-        memcpy_P(buffer,e_accent, 8);                 // é, "Miércoles"
-        lcd.createChar(ES_e_ACCENT, buffer);
-    }
+Argument List: char *p = where to write
+               const char *utf8 = text, in RAM (TextUtf8) or PROGMEM (TextUtf8_P)
+               byte maxLength = no of characters at most, not bytes
+               boolean progmem = true if utf8 is in PROGMEM, see TextUtf8_P()
 
-    if (strcmp(languages[languageNumber],"is ") == 0 || strcmp(languages[languageNumber],"non") == 0)
-    {
-    //  Icelandic, á, ð, Þ, also Old Norse
-    //  https://einhugur.com/blog/index.php/xojo-gpio/hd44780-based-lcd-display/
-        memcpy_P(buffer,Thorn, 8);
-        lcd.createChar(IS_THORN_CAPITAL, buffer);
-        memcpy_P(buffer,eth, 8);
-        lcd.createChar(IS_eth_SMALL, buffer);
-  //      LCDchar6_7 = LCDNATIVE; // since it fills more than locations 4 and 5
-    }
-    if (strcmp(languages[languageNumber],"non") == 0 || strcmp(languages[languageNumber],"fo ") == 0)  // Old Norse, 10.10.2024; Faroese 29.10.2024
-    {   
-        //if (day == Wednesday ... hard to find a suitable variable for weekday which also knows if it is local time or UTC
-        //     memcpy_P(buffer,O_accent, 8);
-        memcpy_P(buffer,o_accent, 8);
-        lcd.createChar(NORSE_o_ACCENT, buffer);
-        LCDchar6_7 = LCDNATIVE; // since it fills more than locations 4 and 5 - 30.11.2024
-    }   
-
-    if (strcmp(languages[languageNumber],"fo ") == 0)  // Faroese 29.10.2024 
-    {
-        memcpy_P(buffer,y_accent, 8);
-        lcd.createChar(FO_y_ACCENT, buffer);
+Return value: pointer to the terminating NUL
+*****/
 
-        memcpy_P(buffer,i_accent, 8);
-        lcd.createChar(FO_i_ACCENT, buffer);
-       // LCDchar6_7 = LCDNATIVE; // since it fills more than locations 4 and 5   
-    }
+char *TextUtf8(char *p, const char *utf8, byte maxLength = 255, boolean progmem = false)
+{
+  for (byte length = 0; length < maxLength; length++)
+  {
+    byte c = progmem ? pgm_read_byte(utf8) : *utf8;
+    if (c == 0) break;
+    utf8++;
 
-    LCDchar4_5 = LCDNATIVE;
-    presentLanguageNumber = languageNumber;
+    uint16_t codePoint = c;
+    byte following = 0;                   // continuation bytes
+    if (c >= 0xE0)      { codePoint = c & 0x0F; following = 2; }
+    else if (c >= 0xC0) { codePoint = c & 0x1F; following = 1; }
 
-    //   lcd.clear();  // in order to set the LCD back to the proper memory mode after custom characters have been created
-        #ifdef FEATURE_SERIAL_LOAD_CHARACTERS
-              Serial.print(F("loadNativeCharacters: ")); Serial.print(languageNumber); 
-              Serial.print(" ");Serial.println(languages[languageNumber]);
-        #endif
- }
+    for (; following > 0; following--)
+    {
+      c = progmem ? pgm_read_byte(utf8) : *utf8;
+      if ((c & 0xC0) != 0x80) break;      // malformed, becomes TEXT_UNKNOWN
+      utf8++;
+      codePoint = (codePoint << 6) | (c & 0x3F);
+    }
+    *p++ = TextCharacter(following == 0 ? codePoint : 0xFFFF);
+  }
+  *p = '\0';
+  return p;
 }
 
-//////////////////////////
-
-#ifdef MORELANGUAGES // unfinished ... dayAddr not declared
-void loadNorseO(int8_t languageNumber)      // make sure correct Ó (Ódinsdagr) and ó (Thórsdagr) is loaded depending on day
+char *TextUtf8_P(char *p, const char *utf8, byte maxLength = 255)
 {
-    int dayAddr; // faked in order for code to compile - needs to come from outside
-    // special case for Old Norse as not enough room for both Ó (Ódinsdagr) and ó (Thórsdagr))
-        if (strcmp(languages[languageNumber],"non") == 0)
-          //      Serial.println(dayAddr);
-        {
-        // if (weekday(localTime) == 4)        // Wednesday: Ó 
-        if (dayAddr == 3)        // Wednesday: Ó 
-            {
-              //  Serial.println("Wednesday OOOO");
-                // memcpy_P(buffer, O_accent, 8);
-                // lcd.createChar(NORSE_O_ACCENT, buffer);
-            }
-        // else if (weekday(localTime) == 5)  // Thursday: ó 
-        else if (dayAddr == 4)  // Thursday: ó 
-            {
-              //  Serial.println("Thursday  oooo");
-                memcpy_P(buffer, o_accent, 8);
-                lcd.createChar(NORSE_o_ACCENT, buffer);
-            }
-        }
-    }
-#endif
-   
+  return TextUtf8(p, utf8, maxLength, true);
+}
 
-//////////////////////////
-void loadAring()   // for use with WordClockNorwegian()
-// New 02.03.2024
+void LcdPrintUtf8(const char *utf8)  // at the cursor
 {
-  if (LCDchar6_7 != LCDARING)
+  char text[LCD_COLS + 1];
+  TextUtf8(text, utf8, LCD_COLS);
+  lcd.print(text);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void dayName(int dayAddr)   // return day name in correct language in "today", given dayAddr=1...7 (Sunday ... Saturday)
 {
-   memcpy_P(buffer,AA_capital, 8);
-   lcd.createChar(SCAND_AA_CAPITAL, buffer); //  Norwegian, Å: "Åtte"
+  TextUtf8_P(today, myDays[languageNumber][dayAddr], 12);  // 12 characters at most, also for UTF-8
+}
 
-   memcpy_P(buffer,AA_small, 8);
-   lcd.createChar(SCAND_aa_SMALL, buffer);   //  Norwegian, å: "åtte"
+/////////////////////////////////////////////////////////////////////////
+
+void nativeDayLong(time_t unixTime) {  // unix time in sec, output through global char array today. Was float, now time_t. Fix 12.10.2024
+ //  Full weekday name in native (= non-English language)
+ //  Max 12 characters in name
+ //  
 
-   LCDchar6_7 = LCDARING;
+int dayAddr = weekday(unixTime) - 1; // weekday() = day of the week (1-7), Sunday is day 1
 
-   #ifdef FEATURE_SERIAL_LOAD_CHARACTERS
-     Serial.println(F("loadAring"));
-  #endif
+#ifdef FEATURE_DAY_PER_SECOND     //    fake the day -- for testing only
+          dayAddr = second(localTime/2)%7; // change every 2 seconds
+#endif
 
-}
+dayName(dayAddr);
 }
 
-
 /////////////////////////////
 
 void WordClockNorwegian()
 { // could be in PROGMEM
-  char WordOnes[10][5] = {{"null"}, {"en  "}, {"to  "}, {"tre "}, {"fire"}, {"fem "}, {"seks"}, {"sju "}, {"xtte"}, {"ni  "}}; // left justified
-  char CapiOnes[10][5] = {{"Null"}, {"Ett "}, {"To  "}, {"Tre "}, {"Fire"}, {"Fem "}, {"Seks"}, {"Sju "}, {"Xtte"}, {"Ni  "}}; // left justified
-  char WordTens[6][7]  = {{"  Null"}, {"    Ti"}, {"  Tjue"}, {"Tretti"}, {" FXrti"}, {" Femti"}}; 
+  char WordOnes[10][6] = {{"null"}, {"en  "}, {"to  "}, {"tre "}, {"fire"}, {"fem "}, {"seks"}, {"sju "}, {"åtte"}, {"ni  "}}; // left justified, UTF-8
+  char CapiOnes[10][6] = {{"Null"}, {"Ett "}, {"To  "}, {"Tre "}, {"Fire"}, {"Fem "}, {"Seks"}, {"Sju "}, {"Åtte"}, {"Ni  "}}; // left justified
+  char WordTens[6][8]  = {{"  Null"}, {"    Ti"}, {"  Tjue"}, {"Tretti"}, {" Førti"}, {" Femti"}}; 
   char Teens[10][8]    = {{"       "},{"Elleve "},{"Tolv   "},{"Tretten"}, {"Fjorten"}, {"Femten "}, {"Seksten"}, {"Sytten "}, {"Atten  "}, {"Nitten "}};
   int ones, tens;
   char textbuf[21];
 
-// replace some characters - the X's - with native Norwegian ones:
-  WordTens[4][2] = (char)NO_DA_oe_SMALL;          // Førti, 'ø' also used in "lørdag", "søndag"
-  WordOnes[8][0] = (char)SCAND_aa_SMALL;          // åtte,  'å'
-  CapiOnes[8][0] = (char)SCAND_AA_CAPITAL;        // Åtte,  'Å'
-
   /* The longest symbol
    *  Hours:            xx: ?? 
    *  Minutes, seconds: 37: Thirty-seven
@@ -279,12 +183,7 @@ void WordClockNorwegian()
    */
  
   //  get local time
-  #ifdef FEATURE_DATE_PER_SECOND                                 // for stepping date quickly and check calender function
-    localTime = now() + utcOffset * 60 + dateIteration * SPEED_UP_FACTOR;  // fake local time by stepping up to 1 sec/day
-    dateIteration = dateIteration + 1;
-  #else 
-    localTime = now() + utcOffset * 60;  // the default!
-  #endif
+  localTime = now() + utcOffset * 60;  // the default!
 
   Hour = hour(localTime);
   Minute = minute(localTime);
@@ -293,20 +192,20 @@ void WordClockNorwegian()
   lcd.setCursor(0, 0); 
   if (Hour < 10) 
   {
-    lcd.print(CapiOnes[int(Hour)]); lcd.print(F("      "));
+    LcdPrintUtf8(CapiOnes[int(Hour)]); lcd.print(F("      "));
   }
   else if (Hour > 10 && Hour < 20) lcd.print(Teens[int(Hour)-10]);
   else
   {
     ones = Hour % 10; tens = (Hour - ones) / 10;
-    lcd.print(WordTens[tens]); 
+    LcdPrintUtf8(WordTens[tens]); 
   if (tens == 0) 
     {
       lcd.print(" ");
-      lcd.print(WordOnes[ones]);
+      LcdPrintUtf8(WordOnes[ones]);
     }
     else if (ones == 0) lcd.print(F("      "));
-    else lcd.print(WordOnes[ones]);
+    else LcdPrintUtf8(WordOnes[ones]);
   }
   
   lcd.setCursor(4,1); 
@@ -314,14 +213,14 @@ void WordClockNorwegian()
   else
   {
     ones = Minute % 10; tens = (Minute - ones) / 10;
-    lcd.print(WordTens[tens]); 
+    LcdPrintUtf8(WordTens[tens]); 
    if (tens == 0) 
     {
       lcd.print(" ");
-      lcd.print(WordOnes[ones]);
+      LcdPrintUtf8(WordOnes[ones]);
     }
     else if (ones == 0) lcd.print(F("      "));
-    else lcd.print(WordOnes[ones]);
+    else LcdPrintUtf8(WordOnes[ones]);
   }
    
   lcd.setCursor(8, 2); 
@@ -329,14 +228,14 @@ void WordClockNorwegian()
   else
   {
     ones = Seconds % 10; tens = (Seconds - ones) / 10;
-    lcd.print(WordTens[tens]);
+    LcdPrintUtf8(WordTens[tens]);
     if (tens == 0) 
     {
       lcd.print(" ");
-      lcd.print(WordOnes[ones]);
+      LcdPrintUtf8(WordOnes[ones]);
     }
     else if (ones == 0) lcd.print(F("      "));
-    else lcd.print(WordOnes[ones]);
+    else LcdPrintUtf8(WordOnes[ones]);
   }
   
    lcd.setCursor(0, 3);lcd.print(F("        "));
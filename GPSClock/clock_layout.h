@@ -0,0 +1,183 @@
+// Screen layouts in PROGMEM: fields which are only formatted and written when what they show has changed.
+// Refresh cadence of clock faces: their expensive part is only recomputed when what it depends on has changed
+
+/*
+InputsChanged
+LayoutInputs
+LayoutRender
+CadenceBegin
+ */
+
+// A layout is a table of fields in PROGMEM: column, row, width, the inputs the field depends on, and a formatter.
+// LayoutRender() finds which inputs have changed since the previous call, and only calls the formatters of the
+// fields which depend on one of them. The other fields stay as they are in the shadow copy of the display
+// (clock_lcd.h), and cost neither computation nor LCD traffic. All fields are drawn if another layout was drawn
+// last time, or if the display has been cleared since (e.g. new screen, demo mode).
+//
+// A formatter prints at the cursor, at most width characters, as the field is blanked first. Its argument comes from
+// the table, so that one formatter can serve e.g. several time zones. Fields are drawn in the order of the table.
+//
+// Screens can be moved over one at a time, TimeZones() is the first one.
+// With FEATURE_SERIAL_BENCHMARK, formatted and skipped fields are counted per screen, see BenchmarkScreens()
+//
+// Cadence: each face declares the inputs of its expensive part in FACE_LIST (clock_defines.h), e.g. LAYOUT_MINUTE |
+// LAYOUT_POSITION for sun and moon rise/set, LAYOUT_DAY for the Hebrew date, or LAYOUT_TOGGLE with a period for faces
+// which alternate between two views. ScreenSelect() calls CadenceBegin() with them, and the face only recomputes when
+// faceRecompute is set; otherwise it just writes the time, and the rest stays as it is in the shadow copy of the
+// display. It is set for all inputs after a clear, a change of face, or oldMinute = -1 (setup menu, benchmark).
+// With FEATURE_DIAGNOSTICS or FEATURE_SERIAL_BENCHMARK, recomputations done and avoided are counted (Diagnostics screen)
+
+#define LAYOUT_SECOND     0x01  // now()
+#define LAYOUT_MINUTE     0x02
+#define LAYOUT_DAY        0x04  // local date
+#define LAYOUT_POSITION   0x08  // latitude, longitude, to 1/100 degree (ca 1 km), so that GPS noise doesn't count
+#define LAYOUT_LANGUAGE   0x10  // languageNumber
+#define LAYOUT_DATEFORMAT 0x20  // dateFormat
+#define LAYOUT_TOGGLE     0x40  // now() / period, for faces which alternate between views
+#define LAYOUT_ALL        0xFF  // draw all fields
+
+struct LayoutField
+{
+  uint8_t col, row, width;
+  uint8_t inputs;               // LAYOUT_SECOND | ...: formatted when one has changed. 0 = only when all are drawn
+  void (*format)(uint8_t arg);
+  uint8_t arg;
+};
+
+#define LAYOUT(fields) fields, sizeof(fields) / sizeof(fields[0])  // arguments for LayoutRender()
+
+struct InputState               // inputs at the previous call of InputsChanged()
+{
+  const void *owner;            // layout or face drawn
+  uint8_t clears;               // lcd.clears
+  time_t  time;                 // now()
+  long    latitude, longitude;  // 1/100 degree
+  int8_t  language;
+  int8_t  dateFormat;
+};
+
+InputState layoutState = {NULL};
+
+#ifdef FEATURE_SERIAL_BENCHMARK
+uint32_t layoutFormatted = 0;          // fields formatted
+uint32_t layoutSkipped = 0;            // fields left as they were
+#endif
+
+/*****
+Purpose:
+Finds the inputs which have changed since the previous call, and remembers them for the next
+
+Argument List: InputState *last = inputs at the previous call, updated
+               const void *owner = the layout or face to be drawn
+               uint8_t period = seconds, for LAYOUT_TOGGLE, 0 = none
+
+Return value: LAYOUT_SECOND | ... for those which have changed, LAYOUT_ALL if another owner or the display was cleared
+*****/
+
+byte InputsChanged(InputState *last, const void *owner, uint8_t period)
+{
+  time_t timeNow = now();
+#ifndef DEBUG_MANUAL_POSITION
+  long latitudeNow  = long(gps.location.lat() * 100.0);
+  long longitudeNow = long(gps.location.lng() * 100.0);
+#else
+  long latitudeNow  = long(latitude_manual * 100.0);
+  long longitudeNow = long(longitude_manual * 100.0);
+#endif
+
+  byte changed = 0;
+  if (timeNow != last->time)                   changed |= LAYOUT_SECOND;
+  if (timeNow / 60 != last->time / 60)         changed |= LAYOUT_MINUTE;
+  if ((timeNow + utcOffset * 60L) / 86400L != (last->time + utcOffset * 60L) / 86400L) changed |= LAYOUT_DAY;
+  if (latitudeNow != last->latitude || longitudeNow != last->longitude)               changed |= LAYOUT_POSITION;
+  if (languageNumber != last->language)        changed |= LAYOUT_LANGUAGE;
+  if (dateFormat != last->dateFormat)          changed |= LAYOUT_DATEFORMAT;
+  if (period > 0 && timeNow / period != last->time / period) changed |= LAYOUT_TOGGLE;
+  if (owner != last->owner || lcd.clears != last->clears) changed = LAYOUT_ALL;
+
+  last->owner      = owner;
+  last->clears     = lcd.clears;
+  last->time       = timeNow;
+  last->latitude   = latitudeNow;
+  last->longitude  = longitudeNow;
+  last->language   = languageNumber;
+  last->dateFormat = dateFormat;
+  return changed;
+}
+
+byte LayoutInputs(const LayoutField *layout)  // inputs changed since the previous layout was drawn
+{
+  return InputsChanged(&layoutState, layout, 0);
+}
+
+/*****
+Purpose:
+Draws the fields of a layout whose inputs have changed
+
+Argument List: const LayoutField *layout = table in PROGMEM
+               uint8_t n = no of fields
+
+Return value: Displays on LCD
+*****/
+
+void LayoutRender(const LayoutField *layout, uint8_t n)
+{
+  byte changed = LayoutInputs(layout);
+
+  for (uint8_t i = 0; i < n; i++)
+  {
+    LayoutField field;
+    memcpy_P(&field, &layout[i], sizeof(field));
+    if (changed != LAYOUT_ALL && (field.inputs & changed) == 0)
+    {
+#ifdef FEATURE_SERIAL_BENCHMARK
+      layoutSkipped++;
+#endif
+      continue;
+    }
+
+    lcd.setCursor(field.col, field.row);
+    for (uint8_t c = 0; c < field.width; c++) lcd.write(' ');
+    lcd.setCursor(field.col, field.row);
+    field.format(field.arg);
+#ifdef FEATURE_SERIAL_BENCHMARK
+    layoutFormatted++;
+#endif
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+InputState cadenceState = {NULL};
+boolean faceRecompute = true;          // set by CadenceBegin() for the face being drawn
+
+#if defined(FEATURE_DIAGNOSTICS) || defined(FEATURE_SERIAL_BENCHMARK)
+uint32_t cadenceRecomputed = 0;        // faces which recomputed
+uint32_t cadenceAvoided = 0;           // faces which only refreshed the time
+#endif
+
+/*****
+Purpose:
+Finds out whether the face about to be drawn must recompute, i.e. sets faceRecompute. Called by ScreenSelect()
+
+Argument List: const void *face = entry in faces[], identifies the face
+               uint8_t refresh = LAYOUT_SECOND | ...: inputs of the face's expensive part, see FACE_LIST
+               uint8_t period = seconds, for LAYOUT_TOGGLE
+
+Return value: none
+*****/
+
+void CadenceBegin(const void *face, uint8_t refresh, uint8_t period)
+{
+  byte changed = InputsChanged(&cadenceState, face, period);
+  if (oldMinute == -1) changed = LAYOUT_ALL;  // immediate display of all info
+  faceRecompute = ((changed & refresh) != 0) || jobPublished;  // a job's result is drawn at once, see clock_jobs.h
+  jobPublished = false;
+
+#if defined(FEATURE_DIAGNOSTICS) || defined(FEATURE_SERIAL_BENCHMARK)
+  if (faceRecompute) cadenceRecomputed++;
+  else               cadenceAvoided++;
+#endif
+}
+
+// THE END /////
@@ -0,0 +1,458 @@
+// LCD output layer, sits between the clock faces and the LCD library
+
+/*
+ShadowLcd
+ */
+
+// The LCD object is declared with LCD_TYPE(library class) in GPSClock.ino, which wraps the library class in ShadowLcd.
+//
+// ShadowLcd keeps two copies of the 20x4 display: frame[][] is what the clock faces have written, shown[][] what
+// has been sent to the display. Only characters which differ are sent, and setCursor() is only sent when the next
+// changed character isn't where the display's cursor already is. Most screens rewrite their whole layout every second,
+// but only a few characters (e.g. seconds) change, so this removes most of the traffic to the display.
+//
+// Between beginFrame() and commit() (used around ScreenSelect() in updateDisplay()), nothing is sent until commit(),
+// and clear() only blanks the frame, so that a clear + redraw of the same text costs nothing. Outside of that, e.g. in
+// the setup menu, every character is sent at once (if changed), and clear() clears the display.
+//
+// updateDisplay() ends the frame with endFrame() instead of commit(): the changed characters are then the queue, and
+// loop() sends them with drain() in time slices of LCD_SLICE_US, with readGPS() and checkEncoder() in between. A screen
+// which changes all 80 characters therefore no longer blocks the reading of GPS for the whole time it takes to send
+// them. queuePeak is the largest no of changed characters in a frame, shown by FEATURE_DIAGNOSTICS. A screen which
+// must not be seen half sent (big digits over several rows, see clock_bigdigits.h) calls atOnce() while it is drawn
+//
+// With DISPLAY_ON_PPS, a frame drawn in advance is kept back with holdFrame() and sent after releaseFrame(), see
+// clock_display.h. clear() outside of a frame drops it, as it was drawn on top of what is no longer on the display.
+// Custom characters uploaded while it is drawn (aheadFrame() until holdFrame()) would change the characters of the
+// frame still on the display, so they are kept back too, and uploaded by releaseFrame(), or forgotten if it is dropped
+//
+// The library class may hold characters back to send them in batches (LcdI2cBatch in clock_lcd_i2c.h), so flush() is
+// called when a frame or a string has been sent. For the other library classes this is Print::flush(), which does nothing.
+//
+// With FEATURE_SERIAL_BENCHMARK, bytes and commands actually sent to the display are counted
+//
+// If the library reports a failed write (hd44780 write() returns 0), failed is set and nothing more is sent, until
+// restore() has re-initialised the display, see LcdBusCheck() in clock_display.h. The frame is kept meanwhile, and
+// restore() uploads the custom characters again and has drain() send all of it. It does so in steps, one per pass of
+// loop(), as begin() alone takes about 100 ms
+//
+// Custom characters: the display has 8 of them (CGRAM slots 0...7). glyph() remembers which PROGMEM bitmap is in each
+// slot, and only uploads a bitmap which isn't there already. Clock faces which share a slot for different bitmaps
+// (big digits, bars, arrows, native letters) therefore only cost an upload when the content actually changes, and a
+// glyph set which is partly loaded only gets the missing slots. glyphSlot() is for a single character whose slot
+// doesn't matter: it reuses the slot if the bitmap is loaded, otherwise it replaces the least recently used slot (of a
+// given range, e.g. 4...7 for letters in clock_language.h, so that arrows in 0...3 stay)
+
+#define LCD_COLS 20
+#define LCD_ROWS 4
+
+#define LCD_CURSOR_UNKNOWN 255
+#define LCD_GLYPHS 8
+#define LCD_CELLS (LCD_ROWS * LCD_COLS)
+
+#define LCD_SLICE_US 1000     // max time for each drain() from loop(), at least one character is sent
+
+struct LcdGlyph               // one entry of a glyph set in PROGMEM, see ShadowLcd::glyphs()
+{
+  uint8_t slot;
+  const uint8_t *bitmap;      // 8 bytes in PROGMEM
+};
+
+#define GLYPH_SET(set) set, sizeof(set) / sizeof(set[0])  // arguments for ShadowLcd::glyphs()
+
+template <class LCD> class ShadowLcd : public LCD
+{
+  public:
+    using LCD::LCD;               // same constructors as the library class
+
+    char frame[LCD_ROWS][LCD_COLS];  // written by clock faces, custom characters are 0...7
+    char shown[LCD_ROWS][LCD_COLS];  // on the display
+    uint8_t queueLength = 0;      // changed characters not yet sent by drain()
+    uint8_t queuePeak = 0;        // largest queueLength at endFrame() since startup
+    uint8_t clears = 0;           // no of clear(), i.e. frame[][] is blank when this has changed
+    boolean failed = false;       // a write to the display failed, nothing is sent until restore()
+    uint16_t writeErrors = 0;     // failed writes
+
+#ifdef FEATURE_SERIAL_BENCHMARK
+    uint32_t bytesWritten = 0;    // characters sent to display RAM
+    uint32_t commandsWritten = 0; // setCursor(), clear(), createChar()
+    uint32_t glyphUploads = 0;    // custom characters uploaded by glyph(), not already loaded
+
+    void resetCounters()
+    {
+      bytesWritten = 0;
+      commandsWritten = 0;
+      glyphUploads = 0;
+    }
+#endif
+
+    template <typename... Args> void begin(Args... args)
+    {
+      LCD::begin(args...);        // display is cleared
+      memset(frame, ' ', sizeof(frame));
+      memset(shown, ' ', sizeof(shown));
+      col = row = 0;
+      hwCol = hwRow = 0;
+      memset(glyphBitmap, 0, sizeof(glyphBitmap));
+    }
+
+    size_t write(uint8_t value)
+    {
+      frame[row][col] = value;
+      if (!deferred)
+      {
+        sendCell(row, col);
+        if (!inString) LCD::flush();
+      }
+      if (++col >= LCD_COLS)      // continues on the next row the way the HD44780 does: 0 -> 2 -> 1 -> 3 -> 0
+      {
+        col = 0;
+        row = (row == 0) ? 2 : (row == 2) ? 1 : (row == 1) ? 3 : 0;
+      }
+      return 1;
+    }
+    using Print::write;           // keep write(const char *) etc
+
+    size_t write(const uint8_t *buffer, size_t size)  // print() of a string: flushed once at the end
+    {
+      inString = true;
+      for (size_t i = 0; i < size; i++) write(buffer[i]);
+      inString = false;
+      LCD::flush();
+      return size;
+    }
+
+    void setCursor(uint8_t newCol, uint8_t newRow)
+    {
+      col = min(newCol, uint8_t(LCD_COLS - 1));
+      row = min(newRow, uint8_t(LCD_ROWS - 1));
+    }
+
+    void clear()
+    {
+      memset(frame, ' ', sizeof(frame));
+      col = row = 0;
+      clears++;
+      if (deferred) return;       // commit() sends what differs
+
+#ifdef FEATURE_SERIAL_BENCHMARK
+      commandsWritten++;
+#endif
+      memset(shown, ' ', sizeof(shown));
+#ifdef DISPLAY_ON_PPS
+      if (holding) dropGlyphs();
+      holding = false;
+#endif
+      if (failed) return;         // restore() clears it
+      LCD::clear();
+      hwCol = hwRow = 0;
+    }
+
+    void createChar(uint8_t location, uint8_t charmap[])
+    {
+#ifdef FEATURE_SERIAL_BENCHMARK
+      commandsWritten++;
+      bytesWritten += 8;
+#endif
+#ifdef DISPLAY_ON_PPS
+      if (ahead)                  // uploaded by releaseFrame()
+      {
+        memcpy(aheadMaps[location & 7], charmap, 8);
+        aheadGlyphs |= 1 << (location & 7);
+        glyphBitmap[location & 7] = NULL;
+        return;
+      }
+#endif
+      if (failed) return;         // glyph() has noted the bitmap, restore() uploads it
+      LCD::createChar(location, charmap);
+      LCD::flush();
+      hwCol = LCD_CURSOR_UNKNOWN;  // address counter now points into CGRAM
+      glyphBitmap[location & 7] = NULL;  // not from glyph(), content unknown
+    }
+
+    /*****
+    Purpose:
+    Puts a custom character from PROGMEM into a given CGRAM slot, unless it is there already
+
+    Argument List: uint8_t slot = 0...7
+                   const uint8_t *bitmap = 8 bytes in PROGMEM
+
+    Return value: true if it was uploaded, false if it was already loaded
+    *****/
+
+    boolean glyph(uint8_t slot, const uint8_t *bitmap)
+    {
+      glyphUsed[slot] = ++glyphClock;
+      if (glyphBitmap[slot] == bitmap) return false;
+
+      uint8_t charmap[8];
+      memcpy_P(charmap, bitmap, 8);
+      createChar(slot, charmap);
+      glyphBitmap[slot] = bitmap;
+#ifdef FEATURE_SERIAL_BENCHMARK
+      glyphUploads++;
+#endif
+      return true;
+    }
+
+    boolean glyphs(const LcdGlyph *set, uint8_t n)  // set in PROGMEM, returns true if any was uploaded
+    {
+      boolean uploaded = false;
+      for (uint8_t i = 0; i < n; i++)
+        uploaded |= glyph(pgm_read_byte(&set[i].slot), (const uint8_t *)pgm_read_ptr(&set[i].bitmap));
+      return uploaded;
+    }
+
+    /*****
+    Purpose:
+    Gets a custom character from PROGMEM into a CGRAM slot, replacing the least recently used one if not loaded
+
+    Argument List: const uint8_t *bitmap = 8 bytes in PROGMEM
+                   uint8_t first, last = range of slots to choose from, default all
+
+    Return value: slot, i.e. the character code to write
+    *****/
+
+    uint8_t glyphSlot(const uint8_t *bitmap, uint8_t first = 0, uint8_t last = LCD_GLYPHS - 1)
+    {
+      uint8_t slot = first;
+      for (uint8_t i = first; i <= last; i++)
+      {
+        if (glyphBitmap[i] == bitmap)
+        {
+          slot = i;
+          break;
+        }
+        if (glyphUsed[i] < glyphUsed[slot]) slot = i;
+      }
+      glyph(slot, bitmap);
+      return slot;
+    }
+
+    void beginFrame()
+    {
+      deferred = true;
+      wholeFrame = false;
+    }
+
+    void atOnce()                 // this frame is sent by one drain(), not in time slices
+    {
+      wholeFrame = true;
+    }
+
+    /*****
+    Purpose:
+    Ends deferred mode. The characters of frame[][] which differ from what is on the display are sent by drain()
+    *****/
+
+    void endFrame()
+    {
+      deferred = false;
+      drainPos = 0;
+      queueLength = 0;
+      for (uint8_t r = 0; r < LCD_ROWS; r++)
+        for (uint8_t c = 0; c < LCD_COLS; c++)
+          if (frame[r][c] != shown[r][c]) queueLength++;
+      queuePeak = max(queuePeak, queueLength);
+    }
+
+    /*****
+    Purpose:
+    Sends changed characters after endFrame() until done or the time is up
+
+    Argument List: uint16_t budgetUs = max time in microseconds, 0 = no limit
+
+    Return value: true when all have been sent
+    *****/
+
+    boolean drain(uint16_t budgetUs)
+    {
+      if (drainPos >= LCD_CELLS) return true;
+      if (deferred) return false;  // next frame is being drawn
+
+      uint32_t startTime = micros();
+      while (drainPos < LCD_CELLS)
+      {
+        uint8_t r = drainPos / LCD_COLS;
+        uint8_t c = drainPos % LCD_COLS;
+        drainPos++;
+        if (frame[r][c] == shown[r][c]) continue;
+        sendCell(r, c);
+        if (queueLength > 0) queueLength--;
+        if (budgetUs != 0 && !wholeFrame && micros() - startTime >= budgetUs) break;
+      }
+      LCD::flush();
+      return drainPos >= LCD_CELLS;
+    }
+
+    void commit()                 // endFrame() and all changed characters sent at once
+    {
+      endFrame();
+      drain(0);
+    }
+
+    boolean drained()             // all changed characters have been sent
+    {
+      return drainPos >= LCD_CELLS;
+    }
+
+    /*****
+    Purpose:
+    Re-initialises the display after failed writes, e.g. after a glitch on the I2C bus, one step per call so that
+    loop() reads the GPS in between: begin(), then the custom characters loaded by glyph(), one per call. Then drain()
+    sends frame[][] again. Nothing else is sent meanwhile. Not to be called between beginFrame() and endFrame()
+
+    Argument List: none
+
+    Return value: true when done
+    *****/
+
+    boolean restore()
+    {
+      if (restoreNext == 0)
+      {
+        failed = false;
+        LCD::begin(LCD_COLS, LCD_ROWS);  // display is cleared
+        memset(shown, ' ', sizeof(shown));
+        hwCol = hwRow = 0;
+        restoreNext = 1;
+        return false;
+      }
+      if (restoreNext <= LCD_GLYPHS)
+      {
+        uint8_t i = restoreNext - 1;
+        const uint8_t *bitmap = glyphBitmap[i];
+#ifdef DISPLAY_ON_PPS
+        if (aheadGlyphs & (1 << i)) bitmap = glyphLive[i];  // the one of the held frame comes with releaseFrame()
+#endif
+        if (bitmap != NULL && !failed)
+        {
+          uint8_t charmap[8];
+          memcpy_P(charmap, bitmap, 8);
+          LCD::createChar(i, charmap);
+          LCD::flush();
+          hwCol = LCD_CURSOR_UNKNOWN;
+        }
+        restoreNext += 1;
+        return false;
+      }
+      restoreNext = 0;
+      endFrame();
+      return true;
+    }
+
+    boolean restoring()           // restore() has been started, and isn't done
+    {
+      return restoreNext != 0;
+    }
+
+    void restoreCancel()          // failed again: start from begin() at the next attempt
+    {
+      restoreNext = 0;
+    }
+
+#ifdef DISPLAY_ON_PPS
+    void aheadFrame()             // custom characters are kept back from here until the frame is released
+    {
+      ahead = true;
+      aheadGlyphs = 0;
+      memcpy(glyphLive, glyphBitmap, sizeof(glyphLive));
+    }
+
+    /*****
+    Purpose:
+    Ends deferred mode, but keeps the frame back until releaseFrame(). Call only when drained()
+
+    Argument List: none
+
+    Return value: none
+    *****/
+
+    void holdFrame()
+    {
+      memcpy(held, frame, sizeof(frame));
+      memcpy(frame, shown, sizeof(frame));  // i.e. as before beginFrame(), as all was sent
+      deferred = false;
+      ahead = false;
+      holding = true;
+    }
+
+    boolean releaseFrame()        // endFrame() for the held frame, false if it was dropped
+    {
+      if (!holding) return false;
+      holding = false;
+      for (uint8_t i = 0; i < LCD_GLYPHS; i++)
+        if ((aheadGlyphs & (1 << i)) && !failed)
+        {
+          LCD::createChar(i, aheadMaps[i]);
+          LCD::flush();
+          hwCol = LCD_CURSOR_UNKNOWN;
+        }
+      aheadGlyphs = 0;
+      memcpy(frame, held, sizeof(frame));
+      endFrame();
+      return true;
+    }
+
+    boolean isHolding()
+    {
+      return holding;
+    }
+#endif
+
+  private:
+    uint8_t col = 0, row = 0;     // where the next character goes in frame[][]
+    uint8_t hwCol = LCD_CURSOR_UNKNOWN, hwRow = 0;  // the display's own cursor
+    boolean deferred = false;
+    boolean wholeFrame = false;   // set by atOnce()
+    boolean inString = false;     // in write() of a string
+    uint8_t drainPos = LCD_CELLS; // next character of frame[][] for drain(), row by row
+    uint8_t restoreNext = 0;      // next step of restore(), 0 = begin()
+#ifdef DISPLAY_ON_PPS
+    char held[LCD_ROWS][LCD_COLS];   // frame kept back by holdFrame()
+    boolean holding = false;
+    boolean ahead = false;           // between aheadFrame() and holdFrame()
+    uint8_t aheadGlyphs = 0;         // bit per CGRAM slot kept back for the held frame
+    uint8_t aheadMaps[LCD_GLYPHS][8];
+    const uint8_t *glyphLive[LCD_GLYPHS];  // glyphBitmap[] at aheadFrame(), i.e. what is in CGRAM
+
+    void dropGlyphs()                // the held frame is dropped: its custom characters were never uploaded
+    {
+      for (uint8_t i = 0; i < LCD_GLYPHS; i++)
+        if (aheadGlyphs & (1 << i)) glyphBitmap[i] = glyphLive[i];
+      aheadGlyphs = 0;
+    }
+#endif
+    const uint8_t *glyphBitmap[LCD_GLYPHS] = {NULL};  // PROGMEM bitmap in each CGRAM slot, NULL = unknown
+    uint16_t glyphUsed[LCD_GLYPHS] = {0};   // glyphClock at last use of each slot
+    uint16_t glyphClock = 0;
+
+    void sendCell(uint8_t r, uint8_t c)
+    {
+      if (frame[r][c] == shown[r][c] || failed || restoreNext != 0) return;
+
+      if (hwCol != c || hwRow != r)
+      {
+        LCD::setCursor(c, r);
+#ifdef FEATURE_SERIAL_BENCHMARK
+        commandsWritten++;
+#endif
+      }
+      if (LCD::write(uint8_t(frame[r][c])) == 0)
+      {
+        failed = true;            // not shown, sent again after restore()
+        writeErrors++;
+        return;
+      }
+#ifdef FEATURE_SERIAL_BENCHMARK
+      bytesWritten++;
+#endif
+      shown[r][c] = frame[r][c];
+      hwRow = r;
+      hwCol = (c + 1 < LCD_COLS) ? c + 1 : LCD_CURSOR_UNKNOWN;  // don't rely on the wrap to the next row
+    }
+};
+
+#define LCD_TYPE(libraryClass) ShadowLcd<libraryClass>
+
+//////////////////// THE END ////////////////////////////////////////
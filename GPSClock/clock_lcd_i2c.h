@@ -0,0 +1,206 @@
+// I2C transport for the LCD: bus timeouts and recovery, and with LCD_I2C_BATCH an hd44780 library i/o class which
+// batches the bus traffic
+
+/*
+I2cBusSetup
+I2cBusClear
+LcdI2cBatch
+ */
+
+// A device on the bus which stops in the middle of a byte (glitch, brown-out, loose wire) holds SDA low, and Wire then
+// waits forever for the bus, i.e. the clock stops, also reading the GPS and setting the time. With a Wire library
+// which has timeouts (WIRE_HAS_TIMEOUT, AVR core 1.8.13 and later), every transaction gives up after LCD_I2C_TIMEOUT.
+// LcdBusCheck() in clock_display.h then stops sending to the LCD (ShadowLcd::failed, clock_lcd.h), and at most every
+// LCD_I2C_RETRY ms clocks SCL until SDA is free (I2cBusClear), re-initialises the display and sends the custom
+// characters and text again (ShadowLcd::restore). Between attempts, nothing is sent to the bus. An attempt is done in
+// steps, one per pass of loop(): the library's begin() (ca 100 ms), then one custom character per step. begin() waits
+// with delay(), and as the LCD task has TASK_YIELDS (clock_tasks.h), the GPS is read from there meanwhile. So the time
+// a bad bus takes from the other tasks is at most one step, i.e. a few transactions at LCD_I2C_TIMEOUT each.
+//
+// Timeouts, failed writes and recoveries are counted, shown on the last page of the Diagnostics screen
+
+// The display is driven in 4-bit mode through the 8 outputs of a PCF8574 on the backpack. Each character is sent as
+// two halves, and each half needs two bytes to the PCF8574: data with E (enable) high, then the same with E low, as
+// the HD44780 latches on the falling edge of E. The usual i/o classes send every half, or every byte, as its own
+// Wire transaction, i.e. a start condition, the address and a stop for every 1-2 bytes of data.
+//
+// LcdI2cBatch instead collects the bytes of a whole run of characters, enable strobes included, in one Wire
+// transaction until the Wire buffer is full: 8 characters in the 32 byte buffer of AVR. Characters and cursor/CGRAM
+// addressing are held back until flush(), which ShadowLcd (clock_lcd.h) calls at the end of commit() and after
+// writes outside of it. All other commands (clear, display on/off, ...) are sent at once, as the hd44780 library times
+// them from when iowrite() returns.
+//
+// The wait for the HD44780 between characters (37 us) is left to the bus: at 100-400 kHz the 4 bytes of a character
+// take 360-90 us. Wiring is fixed to what most backpacks use (same as for OLD_LCD_LIBRARY in GPSClock.ino):
+//    P0 RS, P1 RW, P2 E, P3 backlight (active high), P4-P7 D4-D7
+// The PCF8574 is specified for 100 kHz, but most work at LCD_I2C_CLOCK = 400 kHz. Set 100000 if the display shows garbage.
+//
+// With FEATURE_SERIAL_BENCHMARK, Wire transactions and bytes are counted, see BenchmarkScreens()
+
+#define LCD_I2C_RS  0x01
+#define LCD_I2C_RW  0x02  // not used, always write
+#define LCD_I2C_EN  0x04
+#define LCD_I2C_BL  0x08
+
+#define LCD_I2C_CHEXECTIME  2000  // us, clear and home: 1.52 ms + margin
+#define LCD_I2C_TIMEOUT     5000  // us, max time for a Wire transaction
+#define LCD_I2C_RETRY       2000  // ms, between attempts to restore the display after a bus error
+
+#ifdef BUFFER_LENGTH
+  #define LCD_I2C_BUFFER BUFFER_LENGTH  // Wire transmit buffer
+#else
+  #define LCD_I2C_BUFFER 32
+#endif
+
+uint16_t i2cTimeouts = 0;      // Wire transactions which timed out
+uint16_t i2cRecoveries = 0;    // attempts to restore the display
+
+/*****
+Purpose:
+Sets bus speed and timeout, after Wire.begin(), i.e. after lcd.begin()
+
+Argument List: none
+
+Return value: none
+*****/
+
+void I2cBusSetup()
+{
+  Wire.setClock(LCD_I2C_CLOCK);
+#ifdef WIRE_HAS_TIMEOUT
+  Wire.setWireTimeout(LCD_I2C_TIMEOUT, true);  // true: also reset the I2C hardware on timeout
+#endif
+}
+
+/*****
+Purpose:
+Frees a bus where a device holds SDA low: up to 9 clock pulses on SCL until it lets go, then a stop condition.
+Outputs are only driven low, as the bus is open collector. Wire is stopped, lcd.begin() starts it again
+
+Argument List: none
+
+Return value: true if SDA is free
+*****/
+
+boolean I2cBusClear()
+{
+  Wire.end();                // pins back to digital i/o
+  pinMode(SDA, INPUT);       // pull-ups are on the bus
+  pinMode(SCL, INPUT);
+  digitalWrite(SCL, LOW);    // level when made an output
+  digitalWrite(SDA, LOW);
+
+  for (byte pulse = 0; pulse < 9 && digitalRead(SDA) == LOW; pulse++)
+  {
+    pinMode(SCL, OUTPUT);    // low
+    delayMicroseconds(5);
+    pinMode(SCL, INPUT);     // high
+    delayMicroseconds(5);
+  }
+
+  pinMode(SDA, OUTPUT);      // stop: SDA goes high while SCL is high
+  delayMicroseconds(5);
+  pinMode(SDA, INPUT);
+  delayMicroseconds(5);
+  return digitalRead(SDA) == HIGH;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+#if defined(LCD_I2C_BATCH) && !defined(OLD_LCD_LIBRARY)
+
+class LcdI2cBatch : public hd44780
+{
+  public:
+    LcdI2cBatch(uint8_t address = LCD_I2C_ADDRESS) : i2cAddress(address) {}
+
+#ifdef FEATURE_SERIAL_BENCHMARK
+    uint32_t i2cFrames = 0;       // Wire transactions
+    uint32_t i2cBytes = 0;        // bytes to the PCF8574, address not included
+
+    void resetBusCounters()
+    {
+      i2cFrames = 0;
+      i2cBytes = 0;
+    }
+#endif
+
+    void flush()                  // sends what has been held back
+    {
+      if (queued == 0) return;
+      if (Wire.endTransmission() != 0) busError = true;  // no answer, or timeout
+      queued = 0;
+    }
+
+  private:
+    uint8_t i2cAddress;
+    uint8_t backlight = LCD_I2C_BL;
+    uint8_t queued = 0;           // bytes in the Wire buffer since beginTransmission()
+    boolean busError = false;     // a transaction has failed since ioinit(), reported by iowrite()
+
+    void queue(uint8_t bits)      // one byte to the PCF8574 outputs
+    {
+      if (queued == 0)
+      {
+        Wire.beginTransmission(i2cAddress);
+#ifdef FEATURE_SERIAL_BENCHMARK
+        i2cFrames++;
+#endif
+      }
+      Wire.write(bits);
+#ifdef FEATURE_SERIAL_BENCHMARK
+      i2cBytes++;
+#endif
+      if (++queued >= LCD_I2C_BUFFER) flush();
+    }
+
+    void half(uint8_t value, uint8_t rs)  // upper 4 bits of value to D4-D7, strobed with E
+    {
+      uint8_t bits = (value & 0xF0) | rs | backlight;
+      queue(bits | LCD_I2C_EN);
+      queue(bits);
+    }
+
+    // i/o class functions called by the hd44780 library
+
+    int ioinit()
+    {
+      Wire.begin();
+      Wire.setClock(LCD_I2C_CLOCK);
+      setExecTimes(LCD_I2C_CHEXECTIME, 0);  // clear, home; the 37 us of the others come from the bus, see above
+      queued = 0;
+      busError = false;
+      Wire.beginTransmission(i2cAddress);
+      Wire.write(backlight);      // E low
+      return Wire.endTransmission() ? RV_EIO : RV_ENOERR;  // no PCF8574 at this address
+    }
+
+    int ioread(hd44780::iotype type)
+    {
+      return RV_ENOTSUP;          // RW is not used, the library times the instructions instead
+    }
+
+    int iowrite(hd44780::iotype type, uint8_t value)
+    {
+      uint8_t rs = (type == HD44780_IOdata) ? LCD_I2C_RS : 0;
+      half(value, rs);
+      if (type != HD44780_IOcmd4bit) half(value << 4, rs);
+
+      // only characters and set DDRAM/CGRAM address (0x80/0x40) are held back
+      if (type == HD44780_IOcmd4bit || (type == HD44780_IOcmd && (value & 0xC0) == 0)) flush();
+      return busError ? RV_EIO : RV_ENOERR;  // ShadowLcd then stops sending until restore()
+    }
+
+    int iosetBacklight(uint8_t dimvalue)
+    {
+      flush();
+      backlight = dimvalue ? LCD_I2C_BL : 0;
+      queue(backlight);
+      flush();
+      return RV_ENOERR;
+    }
+};
+
+#endif  // LCD_I2C_BATCH
+
+// THE END /////
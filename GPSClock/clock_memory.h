@@ -0,0 +1,172 @@
+// RAM: scratch arena for temporary arrays of clock faces, and measurement of unused stack
+
+/*
+ScratchReset
+ScratchAlloc
+ScratchArray
+
+StackPaint
+StackFree
+
+Footprint
+ */
+
+// Clock faces which need arrays whose size is only known at run time (e.g. Reminder() with one entry per person)
+// take them from a statically sized arena instead of from the stack. The arena is reset before every screen update in
+// ScreenSelect(), so the arrays only live during one call of a clock face. If the arena is full, ScratchAlloc() returns
+// NULL, the overflow is counted, and the clock face shows an error message instead of overwriting other RAM.
+//
+// Size: Reminder() is the largest user: 3 float and 2 int arrays of MAX_NO_OF_PERSONS + 2 elements
+
+#define SCRATCH_SIZE ((MAX_NO_OF_PERSONS + 2) * (3 * sizeof(float) + 2 * sizeof(int)))
+
+uint8_t  scratchArena[SCRATCH_SIZE] __attribute__((aligned(4)));
+uint16_t scratchUsed = 0;       // bytes allocated since ScratchReset()
+uint16_t scratchPeak = 0;       // largest scratchUsed since startup
+uint16_t scratchOverflows = 0;  // no of ScratchAlloc() calls which didn't fit
+
+void ScratchReset()
+{
+  scratchUsed = 0;
+}
+
+/*****
+Purpose:
+Allocates memory from the scratch arena, valid until next ScratchReset()
+
+Argument List: size_t bytes = no of bytes
+
+Return value: pointer to memory, aligned for float and long, NULL if arena is full
+*****/
+
+void *ScratchAlloc(size_t bytes)
+{
+  uint16_t start = (scratchUsed + 3) & ~3;  // 4-byte alignment for ARM processors
+  if (start + bytes > SCRATCH_SIZE)
+  {
+    scratchOverflows = min(scratchOverflows + 1, 65535);
+    return NULL;
+  }
+  scratchUsed = start + bytes;
+  scratchPeak = max(scratchPeak, scratchUsed);
+  return &scratchArena[start];
+}
+
+template <class T> T *ScratchArray(size_t n)  // n elements of type T, NULL if arena is full
+{
+  return (T *)ScratchAlloc(n * sizeof(T));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef FEATURE_DIAGNOSTICS
+
+// Stack painting: at startup, all free RAM between the heap and the stack is filled with a known pattern.
+// StackFree() counts how much of the pattern is still untouched, i.e. the smallest amount of free RAM there has been.
+// If it gets near zero, the stack is about to run into global variables or the heap
+
+#define STACK_PAINT 0xC5
+
+#ifdef __AVR__
+  extern uint8_t __heap_start;
+  extern void *__brkval;
+  #define HEAP_END ((uint8_t *)(__brkval == 0 ? (void *)&__heap_start : __brkval))
+#else
+  extern "C" char *sbrk(int increment);
+  #define HEAP_END ((uint8_t *)sbrk(0))
+#endif
+
+uint8_t *stackPaintStart = NULL;  // lowest painted address
+
+/*****
+Purpose:
+Fills RAM from end of heap to near current stack position with STACK_PAINT. Called at start of setup()
+
+Argument List: none
+
+Return value: none
+*****/
+
+void StackPaint()
+{
+  uint8_t marker;
+  uint8_t *p = HEAP_END;
+  stackPaintStart = p;
+  while (p < &marker - 16) *p++ = STACK_PAINT;  // leave some margin for this function's own stack frame
+}
+
+/*****
+Purpose:
+Finds unused stack, i.e. no of painted bytes not overwritten since startup, counted from end of heap
+
+Argument List: none
+
+Return value: no of bytes, 0 if stack has not been painted
+*****/
+
+uint16_t StackFree()
+{
+  if (stackPaintStart == NULL) return 0;
+  uint8_t *p = max(HEAP_END, stackPaintStart);
+  uint16_t count = 0;
+  while (*p == STACK_PAINT && count < 65535)
+  {
+    p++;
+    count++;
+  }
+  return count;
+}
+
+#endif  // FEATURE_DIAGNOSTICS
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef FEATURE_SERIAL_FOOTPRINT
+
+// Sizes from the linker's symbols, i.e. the same as reported at the end of a build.
+// Flash = program + initial values of .data, RAM = .data + .bss (globals). Stack and heap come in addition
+
+#ifdef __AVR__
+  extern uint8_t __data_start, __data_end, __bss_start, __bss_end, __data_load_end;
+  #define FLASH_USED uint32_t(&__data_load_end)
+  #define DATA_SIZE  uint32_t(&__data_end - &__data_start)
+  #define BSS_SIZE   uint32_t(&__bss_end - &__bss_start)
+#else  // ARM (SAMD)
+  extern uint8_t __etext, __data_start__, __data_end__, __bss_start__, __bss_end__;
+  #define FLASH_USED (uint32_t(&__etext) + uint32_t(&__data_end__ - &__data_start__))
+  #define DATA_SIZE  uint32_t(&__data_end__ - &__data_start__)
+  #define BSS_SIZE   uint32_t(&__bss_end__ - &__bss_start__)
+#endif
+
+/*****
+Purpose:
+Prints build profile, no of screens compiled in, flash and RAM used on serial port
+
+Argument List: none
+
+Return value: Serial output
+*****/
+
+void Footprint()
+{
+  byte screens = 0;
+  for (int screen = 0; screen < noOfScreens; screen++)
+    for (byte i = 0; menuStruct[0].order[i] >= 0; i++)
+      if (menuStruct[0].order[i] == screen) screens++;
+
+  Serial.print(F("Build profile "));
+#ifdef BUILD_PROFILE
+  Serial.print(menuStruct[0].descr);
+#else
+  Serial.print(F("(none)"));
+#endif
+  Serial.print(F(", screens "));   Serial.println(screens);
+  Serial.print(F("Flash "));       Serial.print(FLASH_USED);
+  Serial.print(F(", .data "));     Serial.print(DATA_SIZE);
+  Serial.print(F(", .bss "));      Serial.print(BSS_SIZE);
+  Serial.print(F(", RAM "));       Serial.println(DATA_SIZE + BSS_SIZE);
+}
+
+#endif  // FEATURE_SERIAL_FOOTPRINT
+
+// THE END /////
@@ -12,12 +12,15 @@
 
 //#define EXP_TIDE_SIDEREAL  // Turn on/off experimental (unfinished) options - 
 
+// This one should normally be on:
+#define DISPLAY_ON_PPS    // next second is drawn in advance and shown on the 1PPS pulse (clock_display.h). Costs 175 bytes RAM
+
 #ifdef ARDUINO_SAMD_VARIANT_COMPLIANCE // can be set in clock_hardware.h
    #define MORELANGUAGES  // More than the default set of languages
 #endif
 
 // 1. Software options
-// 1A. subsets of menus
+// 1A. subsets of menus, build profiles
 // 1B. date format
 // 1C. language
 // 1D. time zones
@@ -32,15 +35,37 @@
 // *** Customize menu system. ie. the order in which screen items are presented ***
 // *** and set up set of such menu systems 
 
-// Perturbe the order of screens, making sure that each number *only appears once* per group:
+// Perturbe the order of screens, making sure that each number *only appears once* per group (checked when compiling):
+
+// Build profiles: only the screens of one subset are compiled in, and that subset is the only one in the menu.
+// Saves flash and RAM, as functions (and their data) only used by other screens are removed by the linker.
+// At most one of these:
+//#define BUILD_PROFILE_CALENDAR
+//#define BUILD_PROFILE_CLOCKS
+//#define BUILD_PROFILE_ASTRO
+//#define BUILD_PROFILE_RADIO
+//#define BUILD_SCREEN ScreenLocalUTC  // a single screen
+
+// Flash and RAM per screen: compare with a build with BUILD_SCREEN ScreenCodeStatus, which is always compiled in
+// as the start screen. FEATURE_SERIAL_FOOTPRINT prints the sizes at startup, or let the build do it, e.g. with arduino-cli
+// for the full build, every subset with a profile, and the start screen alone:
+//   for p in NO_PROFILE BUILD_PROFILE_CALENDAR BUILD_PROFILE_CLOCKS BUILD_PROFILE_ASTRO BUILD_PROFILE_RADIO BUILD_SCREEN=ScreenCodeStatus; do
+//     echo $p; arduino-cli compile -b arduino:avr:mega --build-property "compiler.cpp.extra_flags=-D$p" GPSClock |
+//     grep -E "Sketch uses|Global variables"; done
+
+#if defined(BUILD_PROFILE_CALENDAR) || defined(BUILD_PROFILE_CLOCKS) || defined(BUILD_PROFILE_ASTRO) || \
+    defined(BUILD_PROFILE_RADIO) || defined(BUILD_SCREEN)
+  #define BUILD_PROFILE
+#endif
 
 // All = all except the obsolete:
 //   ScreenLocalSun,      superseded by ScreenLocalSunSimpler
 //   ScreenLocalSunAzEl,  superseded by ScreenLocalSunSimpler
    
 // 9 letter description + numbers:   
-Menu_type menuStruct[] =
+constexpr Menu_type menuStruct[] =  // constexpr: ScreenInBuild() below needs it at compile time
 {
+#ifndef BUILD_PROFILE
   {"All      ",  
       ScreenLocalUTCWeek, ScreenUTCLocator, ScreenLocalSunSimpler, ScreenLocalSunMoon, ScreenLocalMoon, 
       ScreenMoonRiseSet, ScreenPlanetsInner, ScreenPlanetsOuter, ScreenISOHebIslam, 
@@ -53,6 +78,12 @@ Menu_type menuStruct[] =
       ScreenChemical, 
       // status
       ScreenCodeStatus, ScreenInternalTime, 
+      #ifdef FEATURE_PROFILER
+         ScreenProfiler,
+      #endif
+      #ifdef FEATURE_DIAGNOSTICS
+         ScreenDiagnostics, ScreenTasks,
+      #endif
       // radio amateur
       ScreenNCDXFBeacons1, ScreenNCDXFBeacons2, ScreenWSPRsequence, 
       ScreenSidereal, ScreenGPSInfo, ScreenBigNumbers2, ScreenBigNumbers2UTC, 
@@ -81,6 +112,8 @@ Menu_type menuStruct[] =
       ScreenLocalUTCWeek, ScreenLocalSunSimpler, ScreenLocalMoon, ScreenPlanetsInner, ScreenPlanetsOuter, 
       ScreenISOHebIslam, ScreenNextEvents, ScreenProgress, ScreenDemoClock,
       -1}, 
+#endif
+#if !defined(BUILD_PROFILE) || defined(BUILD_PROFILE_CALENDAR)
   {"Calendar ", 
       ScreenLocalUTCWeek, ScreenUTCLocator, ScreenLunarEclipse, ScreenEasterDates, ScreenISOHebIslam,   
       ScreenTimeZones,  ScreenUTCPosition,  ScreenCodeStatus, ScreenSidereal, ScreenGPSInfo, 
@@ -90,6 +123,8 @@ Menu_type menuStruct[] =
       #endif   
       ScreenProgress, ScreenDemoClock, 
       -1},
+#endif
+#if !defined(BUILD_PROFILE) || defined(BUILD_PROFILE_CLOCKS)
   {"Clocks   ",
       ScreenLocalUTCWeek, ScreenUTCLocator, ScreenBinary, ScreenBinaryHorBCD, ScreenBinaryVertBCD, 
       ScreenBar, ScreenMengenLehrUhr, ScreenLinearUhr, ScreenHex, ScreenOctal, 
@@ -98,6 +133,8 @@ Menu_type menuStruct[] =
       ScreenChemical, ScreenBigNumbers2, ScreenBigNumbers2UTC, ScreenBigNumbers3, ScreenBigNumbers3UTC, 
       ScreenProgress, ScreenDemoClock, 
       -1},
+#endif
+#if !defined(BUILD_PROFILE) || defined(BUILD_PROFILE_ASTRO)
   {"Astro    ",
       ScreenLocalUTCWeek, ScreenUTCLocator, ScreenLocalSunSimpler, ScreenLocalSunMoon, ScreenLocalMoon, 
       ScreenMoonRiseSet,  ScreenLunarEclipse, ScreenEasterDates, ScreenPlanetsInner, ScreenPlanetsOuter, 
@@ -105,13 +142,20 @@ Menu_type menuStruct[] =
    //   ScreenEquinoxes, ScreenNextEvents, ScreenDemoClock, 
       ScreenEquinoxes, ScreenDemoClock, 
       -1},
+#endif
+#if !defined(BUILD_PROFILE) || defined(BUILD_PROFILE_RADIO)
   {"Radio    ", 
       ScreenLocalUTCWeek, ScreenUTCLocator, ScreenLocalSunSimpler, ScreenLocalMoon, ScreenUTCPosition, 
       ScreenMorse, ScreenCodeStatus, ScreenNCDXFBeacons1, ScreenNCDXFBeacons2, ScreenWSPRsequence, 
       ScreenGPSInfo, ScreenDemoClock, 
-      -1}
-#ifdef TESTSCREENS
-  ,
+      -1},
+#endif
+#ifdef BUILD_SCREEN
+  {"Single   ", 
+      BUILD_SCREEN,
+      -1},
+#endif
+#if defined(TESTSCREENS) && !defined(BUILD_PROFILE)
   {"Test     ", 
       ScreenLocalUTCWeek, ScreenProgress, ScreenISOHebIslam, ScreenMoonRiseSet,
       ScreenBigNumbers2, ScreenBigNumbers3UTC, ScreenDemoClock,
@@ -119,6 +163,48 @@ Menu_type menuStruct[] =
 #endif 
 };
 
+// true if screen is compiled in. With a build profile: if it is in the only subset of menuStruct[]
+#ifdef BUILD_PROFILE
+constexpr bool ScreenInBuild(int screen, int i = 0)
+{
+  return (menuStruct[0].order[i] < 0) ? false : (menuStruct[0].order[i] == screen || ScreenInBuild(screen, i + 1));
+}
+#else
+constexpr bool ScreenInBuild(int screen) { return true; }
+#endif
+
+// Checks of menuStruct[] at compile time: each subset ends with -1 (unless full), and has only known screens,
+// each at most once
+constexpr int noOfSubsets = sizeof(menuStruct) / sizeof(menuStruct[0]);
+
+constexpr bool MenuRepeated(int subset, int i, int j = 0)  // order[i] is also found before i
+{
+  return (j >= i) ? false : (menuStruct[subset].order[j] == menuStruct[subset].order[i] || MenuRepeated(subset, i, j + 1));
+}
+
+constexpr bool MenuValid(int subset, int i = 0)
+{
+  return (i >= noOfScreens || menuStruct[subset].order[i] < 0) ? true :
+         (menuStruct[subset].order[i] < noOfFaces && !MenuRepeated(subset, i) && MenuValid(subset, i + 1));
+}
+
+constexpr bool MenusValid(int subset = 0)
+{
+  return (subset >= noOfSubsets) ? true : (MenuValid(subset) && MenusValid(subset + 1));
+}
+
+static_assert(MenusValid(), "menuStruct[]: unknown or repeated screen in a subset");
+
+// menuOrder[] of a screen which isn't in the chosen subset, e.g. ScreenDemoClock with BUILD_SCREEN: must not be a position
+#define MENU_NONE 0xFF
+static_assert(noOfScreens < MENU_NONE, "menuOrder[]: MENU_NONE must not be a position in a subset");
+#ifdef BUILD_SCREEN
+static_assert(BUILD_SCREEN != ScreenDemoClock, "BUILD_SCREEN: DemoClock alone has no screens to show");
+#endif
+
+template <bool inBuild> struct ScreenBuildFlag { static const bool value = inBuild; };  // forces evaluation at compile time
+#define IN_BUILD(screen) (ScreenBuildFlag<ScreenInBuild(screen)>::value)
+
 // *** 1B. Date/time format
 // **************************************************************************
 // *** Date time format options selectable by rotary
@@ -159,20 +245,21 @@ char languages[][12] = {"en ", "es ", "fr ", "de ", "nb ", "sv ", "da ", "is ",
 #endif
 
 // Order in myDays must match languages[][] above
-const char myDays[][7][12] PROGMEM = {
+// UTF-8, letters which are not in the LCD's character ROM are custom characters, see textGlyphs[] in clock_language.h
+const char myDays[][7][16] PROGMEM = {
             {"Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday"},          // English, en
-            {"Domingo", "Lunes", "Martes", "MiXrcoles", "Jueve", "Viernes", "SXbado"},               // Spanish, es
+            {"Domingo", "Lunes", "Martes", "Miércoles", "Jueve", "Viernes", "Sábado"},               // Spanish, es
             {"dimanche", "lundi", "mardi", "mercredi", "jeudi", "vendredi", "samedi"},               // French, fr
             {"Sonntag", "Montag", "Dienstag", "Mittwoch", "Donnerstag", "Freitag", "Samstag"},       // German, de  
-            {"SXndag", "Mandag", "Tirsdag", "Onsdag", "Torsdag", "Fredag", "LXrdag"},                // Norsk Bokmål (Norwegian), nb                  
-            {"SXndag", "MXndag", "Tisdag", "Onsdag", "Torsdag", "Fredag", "LXrdag"},                 // Swedish, sv  
-            {"SXndag", "Mandag", "Tirsdag", "Onsdag", "Torsdag", "Fredag", "LXrdag"},                // Danish, da  = Norwegian 
-            {"Sunnudagur", "MXnudagur", "XriXjudagur", "MiXvikudag", "Fimmtudagur", "FXstudagur", "Laugardagur"}, // Icelandic, is
+            {"Søndag", "Mandag", "Tirsdag", "Onsdag", "Torsdag", "Fredag", "Lørdag"},                // Norsk Bokmål (Norwegian), nb                  
+            {"Söndag", "Måndag", "Tisdag", "Onsdag", "Torsdag", "Fredag", "Lördag"},                 // Swedish, sv  
+            {"Søndag", "Mandag", "Tirsdag", "Onsdag", "Torsdag", "Fredag", "Lørdag"},                // Danish, da  = Norwegian 
+            {"Sunnudagur", "Mánudagur", "Þriðjudagur", "Miðvikudag", "Fimmtudagur", "Föstudagur", "Laugardagur"}, // Icelandic, is
 #ifdef MORELANGUAGES
-            {"Sunnudagur","Mxnadagur","Txsdagur","Mikudagur", "Hxsdagur", "FrXggjadag.", "Leygardagur"}, // Faeroe Islands. fo
-            {"Sunnudagr", "MXnudagr", "Tysdagr", "Oxinsdagr", "Xxrsdagr", "Frjxdagr", "Laugardagr"}, // Old Norse, non 10.10.2024
+            {"Sunnudagur","Mánadagur","Týsdagur","Mikudagur", "Hósdagur", "Fríggjadag.", "Leygardagur"}, // Faeroe Islands. fo
+            {"Sunnudagr", "Mánudagr", "Tysdagr", "Óðinsdagr", "Þórsdagr", "Frjádagr", "Laugardagr"}, // Old Norse, non 10.10.2024
 #endif
-            {"SXndag", "MXndag", "Tysdag", "Onsdag", "Torsdag", "Fredag", "Laurdag"},                // Nynorsk (Norwegian), nn 
+            {"Søndag", "Måndag", "Tysdag", "Onsdag", "Torsdag", "Fredag", "Laurdag"},                // Nynorsk (Norwegian), nn 
             {"zondag", "maandag", "dinsdag", "woensdag", "donderdag", "vrijdag", "zaterdag"},        // Dutch, nl
 #ifdef MORELANGUAGES
             {"aHad",   "itnein", "talaata", "arba3aa", "khamis", "jum3a", "sabt"}};               // Lebanese (Levantine Arabic), ar
@@ -180,6 +267,18 @@ const char myDays[][7][12] PROGMEM = {
             };
 #endif
 
+// Word for week, before ISO week # in ScreenLocalUTCWeek. Order must match languages[][] above
+const char myWeek[][8] PROGMEM = {
+            "Week ", "Semana ", "Sem. ", "Woche ", "Uke ", "Vecka ", "Uge ", "Vika ",  // "Semaine" is too long
+#ifdef MORELANGUAGES
+            "Week ", "Vika ",
+#endif
+            "Veke ", "Week ",
+#ifdef MORELANGUAGES
+            "Week "
+#endif
+            };
+
 
 
 // *** 1D. Time zones ****************************************************************************
@@ -0,0 +1,319 @@
+// Recording and replay of GPS, PPS and rotary encoder input, for reproducing problems seen in the field
+
+/*
+SessionRotary
+
+SessionWriteRecord
+SessionFlushGPS
+SessionRecordGPS
+SessionRecordPPS
+SessionStart
+
+SessionReadRecord
+SessionReplay
+ */
+
+// FEATURE_SESSION_RECORD: all input to the clock is written to the serial port (Serial) as it is read by loop().
+// Capture it to a file on a PC with a program that saves raw bytes, e.g. on Linux:
+//    stty -F /dev/ttyACM0 115200 raw; cat /dev/ttyACM0 > session.bin
+// GPS must be on Serial1, i.e. not together with FEATURE_FAKE_SERIAL_GPS_IN or other serial debug output.
+//
+// FEATURE_SESSION_REPLAY: GPS, PPS and the rotary encoder are ignored, and the input is read from such a file
+// sent to the serial port. The clock sends XON/XOFF to pace the sender, so use software flow control, e.g. on Linux:
+//    stty -F /dev/ttyACM0 115200 raw ixon; cat session.bin > /dev/ttyACM0
+// Input is replayed with the original timing, or as fast as possible with SESSION_REPLAY_FAST.
+// As input comes in the same order as it was seen by loop(), the clock goes through the same states as when recorded.
+//
+// Format: the line "GPSClock session 1", then records of
+//    type (1 byte), ms since previous record (1-4 bytes, 7 bits per byte, least significant first, bit 7 = more follows), data
+//    'N' NMEA:   no of bytes (1 byte, max SESSION_CHUNK), bytes from GPS
+//    'P' PPS:    no data, 1PPS interrupt seen by syncCheck()
+//    'R' rotary: result of r.process(), DIR_CW or DIR_CCW
+//    'B' button: ms argument (2 bytes, LSB first) of r.buttonPressedReleased() which returned true
+// This covers the setup menu as well, as it reads the same rotary object
+
+#if defined(FEATURE_SESSION_RECORD) || defined(FEATURE_SESSION_REPLAY)
+
+#define SESSION_CHUNK 32  // max NMEA bytes per record
+
+extern TinyGPSPlus gps;  // declared in GPSClock.ino
+void ppsHandler();       // forward declaration
+void GPSEncode(char c);  // forward declaration
+
+void SessionWriteRecord(byte type, const byte data[], byte length);   // forward declarations
+void SessionFlushGPS();
+unsigned char SessionReplayRotary();
+boolean SessionReplayButton(int ms);
+
+class SessionRotary : public Rotary
+{
+  public:
+    using Rotary::Rotary;         // same constructor as Rotary
+
+    unsigned char process()
+    {
+#ifdef FEATURE_SESSION_REPLAY
+      Rotary::process();          // keep the real encoder quiet
+      return SessionReplayRotary();
+#else
+      unsigned char result = Rotary::process();
+      if (result) SessionWriteRecord('R', &result, 1);
+      return result;
+#endif
+    }
+
+    boolean buttonPressedReleased(int ms)
+    {
+#ifdef FEATURE_SESSION_REPLAY
+      Rotary::buttonPressedReleased(ms);
+      return SessionReplayButton(ms);
+#else
+      boolean result = Rotary::buttonPressedReleased(ms);
+      if (result)
+      {
+        byte data[2] = {lowByte(ms), highByte(ms)};
+        SessionWriteRecord('B', data, 2);
+      }
+      return result;
+#endif
+    }
+};
+
+  #define ROTARY_TYPE SessionRotary
+#else
+  #define ROTARY_TYPE Rotary
+#endif
+
+#ifdef FEATURE_SESSION_RECORD
+
+uint32_t sessionLastRecord = 0;       // millis() of previous record
+byte sessionChunk[SESSION_CHUNK];     // NMEA bytes not yet written
+byte sessionChunkLength = 0;
+
+/*****
+Purpose:
+Writes one record to the serial port, see format at top of file
+
+Argument List: byte type = 'N', 'P', 'R', 'B'
+               const byte data[] = data of record
+               byte length = no of bytes in data
+
+Return value: Serial output
+*****/
+
+void SessionWriteRecord(byte type, const byte data[], byte length)
+{
+  if (type != 'N') SessionFlushGPS();  // NMEA bytes received before this event come first
+
+  uint32_t now_ms = millis();
+  uint32_t delta = now_ms - sessionLastRecord;
+  sessionLastRecord = now_ms;
+
+  Serial.write(type);
+  do {
+    byte b = delta & 0x7F;
+    delta >>= 7;
+    Serial.write(delta ? b | 0x80 : b);
+  } while (delta);
+  if (type == 'N') Serial.write(length);
+  Serial.write(data, length);
+}
+
+void SessionFlushGPS()
+{
+  if (sessionChunkLength == 0) return;
+  byte length = sessionChunkLength;
+  sessionChunkLength = 0;
+  SessionWriteRecord('N', sessionChunk, length);
+}
+
+/*****
+Purpose:
+Collects bytes from GPS, writes them as a record when a sentence ends or SESSION_CHUNK bytes have been collected
+
+Argument List: byte c = byte from GPS
+
+Return value: Serial output
+*****/
+
+void SessionRecordGPS(byte c)
+{
+  sessionChunk[sessionChunkLength++] = c;
+  if (c == '\n' || sessionChunkLength >= SESSION_CHUNK) SessionFlushGPS();
+}
+
+void SessionRecordPPS()
+{
+  SessionWriteRecord('P', NULL, 0);
+}
+
+void SessionStart()
+{
+  Serial.begin(115200);
+  Serial.println(F("GPSClock session 1"));
+  sessionLastRecord = millis();
+}
+
+#endif  // FEATURE_SESSION_RECORD
+
+#ifdef FEATURE_SESSION_REPLAY
+
+#define XON  0x11
+#define XOFF 0x13
+
+enum { SESSION_HEADER, SESSION_TYPE, SESSION_DELTA, SESSION_LENGTH, SESSION_DATA, SESSION_READY };
+
+byte sessionState = SESSION_HEADER;
+byte sessionType;
+uint32_t sessionDelta;
+byte sessionShift;
+byte sessionLength, sessionPos;
+byte sessionData[SESSION_CHUNK];
+uint32_t sessionLastRecord = 0;       // millis() when previous record was replayed
+boolean sessionPaused = true;         // XOFF sent
+
+unsigned char sessionRotary = 0;      // replayed events, waiting for checkEncoder() or setup menu
+int sessionButton = 0;                // ms of the recorded press, 0 = none
+int sessionButtonMissed = 0;          // ms of the first call which didn't match it
+
+void SessionStart()
+{
+  Serial.begin(115200);
+  Serial.write(XON);
+  sessionPaused = false;
+  sessionLastRecord = millis();
+}
+
+/*****
+Purpose:
+Reads from serial port until a whole record has been received. Keeps the sender going only while the
+receive buffer is empty, as a burst of data would otherwise overflow it while a screen is being updated
+
+Argument List: none
+
+Return value: true when a record is ready in sessionType, sessionDelta, sessionData, sessionLength
+*****/
+
+boolean SessionReadRecord()
+{
+  while (sessionState != SESSION_READY && Serial.available())
+  {
+    byte b = Serial.read();
+    switch (sessionState)
+    {
+      case SESSION_HEADER:  // skip the text line
+        if (b == '\n') sessionState = SESSION_TYPE;
+        break;
+      case SESSION_TYPE:
+        sessionType  = b;
+        sessionDelta = 0;
+        sessionShift = 0;
+        sessionState = SESSION_DELTA;
+        break;
+      case SESSION_DELTA:
+        sessionDelta |= uint32_t(b & 0x7F) << sessionShift;
+        sessionShift += 7;
+        if (b & 0x80) break;
+        sessionLength = 0;
+        sessionPos    = 0;
+        if      (sessionType == 'N') sessionState = SESSION_LENGTH;
+        else if (sessionType == 'R') { sessionLength = 1; sessionState = SESSION_DATA; }
+        else if (sessionType == 'B') { sessionLength = 2; sessionState = SESSION_DATA; }
+        else                         sessionState = SESSION_READY;
+        break;
+      case SESSION_LENGTH:
+        sessionLength = min(b, byte(SESSION_CHUNK));
+        sessionState = sessionLength ? SESSION_DATA : SESSION_READY;
+        break;
+      case SESSION_DATA:
+        sessionData[sessionPos++] = b;
+        if (sessionPos >= sessionLength) sessionState = SESSION_READY;
+        break;
+    }
+  }
+
+  boolean pause = Serial.available() > 0;
+  if (pause != sessionPaused)
+  {
+    Serial.write(pause ? XOFF : XON);
+    sessionPaused = pause;
+  }
+  return sessionState == SESSION_READY;
+}
+
+/*****
+Purpose:
+Feeds recorded input to the clock, replaces reading of GPS in readGPS()
+NMEA bytes go to gps.encode(), PPS to ppsHandler(), encoder events are held until read via r.process() or
+r.buttonPressedReleased(). Stops after a PPS or encoder event, so loop() sees them one at a time as when recorded
+
+Argument List: none
+
+Return value: none
+*****/
+
+void SessionReplay()
+{
+  while (sessionRotary == 0 && sessionButton == 0 && SessionReadRecord())
+  {
+#ifndef SESSION_REPLAY_FAST
+    if (millis() - sessionLastRecord < sessionDelta) return;  // not yet
+#endif
+    sessionLastRecord += sessionDelta;
+    sessionState = SESSION_TYPE;
+
+    switch (sessionType)
+    {
+      case 'N':
+        for (byte i = 0; i < sessionLength; i++) GPSEncode(sessionData[i]);
+        break;
+      case 'P':
+        ppsHandler();
+        return;
+      case 'R':
+        sessionRotary = sessionData[0];
+        return;
+      case 'B':
+        sessionButton = sessionData[0] | (sessionData[1] << 8);
+        sessionButtonMissed = 0;
+        return;
+    }
+  }
+}
+
+unsigned char SessionReplayRotary()
+{
+  if (sessionRotary == 0 && sessionButton == 0) SessionReplay();  // the setup menu reads the encoder without calling readGPS()
+  unsigned char result = sessionRotary;
+  sessionRotary = 0;
+  return result;
+}
+
+/*****
+Purpose:
+Replays a recorded button press to r.buttonPressedReleased(ms). The press was held at least as long as the ms of the
+call which saw it when recorded, so it is given to the first call with that ms or less, e.g. a short press (25) is
+not given to the test for a long press (500) which comes first in checkEncoder(). If the caller has asked for all
+its ms values, i.e. one of them comes again, without a match, the press is dropped, so that replay goes on
+
+Argument List: int ms = argument of r.buttonPressedReleased()
+
+Return value: true if a press has been replayed for this call
+*****/
+
+boolean SessionReplayButton(int ms)
+{
+  if (sessionButton == 0) return false;
+  if (ms <= sessionButton)
+  {
+    sessionButton = 0;
+    return true;
+  }
+  if (sessionButtonMissed == ms) sessionButton = 0;  // none of the caller's tests matched
+  else if (sessionButtonMissed == 0) sessionButtonMissed = ms;
+  return false;
+}
+
+#endif  // FEATURE_SESSION_REPLAY
+
+// THE END /////
@@ -0,0 +1,137 @@
+// Cooperative scheduler for loop(): named tasks with period, deadline and priority, and their execution time
+
+/*
+TaskStart
+TaskRun
+yield
+ */
+
+// The tasks are listed in a table in PROGMEM, highest priority first (see loop() in GPSClock.ino), and TaskRun() runs
+// the ones which are due, in that order, once per pass of loop(). There is no preemption: a task runs until it
+// returns. Instead, a long task with TASK_YIELDS lets the TASK_URGENT tasks run whenever it calls yield(), which
+// delay() also does, so that the GPS receive buffer is emptied and the rotary encoder is sampled while a slow face is
+// computed.
+//
+// deadline = longest allowed time between two starts of a task. A longer time is counted as a miss.
+// With FEATURE_DIAGNOSTICS: runs, mean and max execution time, and misses per task, shown in ScreenTasks. The time of a
+// task which yields includes the urgent tasks run from it
+
+#define TASK_URGENT 0x01  // also run from yield(), i.e. from within a task with TASK_YIELDS
+#define TASK_YIELDS 0x02  // its calls of yield() and delay() run the urgent tasks
+
+#define TASKS_MAX 8
+
+struct Task
+{
+  void (*run)();
+  uint16_t periodMs;    // 0 = every pass of loop()
+  uint16_t deadlineMs;  // 0 = none
+  uint8_t flags;        // TASK_URGENT, TASK_YIELDS
+  const char *name;     // in PROGMEM, at most 6 characters
+};
+
+const Task *taskTable = NULL;    // in PROGMEM, the one given to TaskRun()
+uint8_t taskCount = 0;
+int8_t taskRunning = -1;         // index in taskTable, -1 = none
+boolean taskInYield = false;     // urgent tasks are being run from yield()
+uint32_t taskLast[TASKS_MAX];    // millis() at last start
+
+#ifdef FEATURE_DIAGNOSTICS
+struct TaskStats
+{
+  uint16_t runs;      // runs in sumUs, both halved when runs is full
+  uint32_t sumUs;
+  uint32_t maxUs;
+  uint16_t misses;    // deadline misses
+  uint16_t maxGapMs;  // longest time between starts
+};
+
+TaskStats taskStats[TASKS_MAX];
+#endif
+
+/*****
+Purpose:
+Starts a task if it is due, i.e. if its period has passed, and records its execution time
+
+Argument List: uint8_t i = index in taskTable
+
+Return value: None
+*****/
+
+void TaskStart(uint8_t i)
+{
+  Task task;
+  memcpy_P(&task, &taskTable[i], sizeof(task));
+
+  uint32_t startMs = millis();
+  uint32_t gap = startMs - taskLast[i];
+  if ((task.periodMs != 0) && (gap < task.periodMs)) return;
+  taskLast[i] = startMs;
+
+#ifdef FEATURE_DIAGNOSTICS
+  TaskStats *stats = &taskStats[i];
+  if (stats->runs > 0)  // the first start has no gap
+  {
+    stats->maxGapMs = max(stats->maxGapMs, uint16_t(min(gap, uint32_t(65535))));
+    if ((task.deadlineMs != 0) && (gap > task.deadlineMs) && (stats->misses < 65535)) stats->misses += 1;
+  }
+  uint32_t startUs = micros();
+#endif
+
+  int8_t outer = taskRunning;
+  taskRunning = i;
+  task.run();
+  taskRunning = outer;
+
+#ifdef FEATURE_DIAGNOSTICS
+  uint32_t duration = micros() - startUs;
+  if (stats->runs == 65535)  // keep the mean, but let it follow changes
+  {
+    stats->runs /= 2;
+    stats->sumUs /= 2;
+  }
+  stats->runs += 1;
+  stats->sumUs += duration;
+  stats->maxUs = max(stats->maxUs, duration);
+#endif
+}
+
+/*****
+Purpose:
+One pass of the scheduler: runs the tasks which are due, highest priority first
+
+Argument List: const Task *tasks = table in PROGMEM, in order of priority
+               uint8_t n = no of tasks, at most TASKS_MAX
+
+Return value: None
+*****/
+
+void TaskRun(const Task *tasks, uint8_t n)
+{
+  taskTable = tasks;
+  taskCount = min(n, uint8_t(TASKS_MAX));
+  for (uint8_t i = 0; i < taskCount; i++) TaskStart(i);
+}
+
+/*****
+Purpose:
+Replaces the empty yield() of the Arduino core, which is called by delay() and may be called from long computations.
+Runs the urgent tasks, when called from a task with TASK_YIELDS
+
+Argument List: None
+
+Return value: None
+*****/
+
+void yield()
+{
+  if ((taskRunning < 0) || taskInYield) return;
+  if (!(pgm_read_byte(&taskTable[taskRunning].flags) & TASK_YIELDS)) return;
+
+  taskInYield = true;
+  for (uint8_t i = 0; i < taskCount; i++)
+    if ((i != taskRunning) && (pgm_read_byte(&taskTable[i].flags) & TASK_URGENT)) TaskStart(i);
+  taskInYield = false;
+}
+
+// THE END /////
@@ -381,24 +381,45 @@ private:
   long year;   // 1...
   long month;  // 1..LastMonthOfHebrewYear(year)
   long day;    // 1..LastDayOfHebrewMonth(month, year)
+  byte search; // Step(): 0 = not started, 1 = year, 2 = month
 
 public:
-  HebrewDate(long m, long d, long y) { month = m; day = d; year = y; }
+  HebrewDate(long m, long d, long y) { month = m; day = d; year = y; search = 0; }
 
   HebrewDate(long d) { // Computes the Hebrew date from the absolute date.
-    year = (d + HebrewEpoch) / 366; // Approximation from below.
-    // Search forward for year from the approximation.
-    while (d >= HebrewDate(7,1,year + 1))
-      year++;
-    // Search forward for month from either Tishri or Nisan.
-    if (d < HebrewDate(1, 1, year))
-      month = 7;  //  Start at Tishri
-    else
-      month = 1;  //  Start at Nisan
-    while (d > HebrewDate(month, (LastDayOfHebrewMonth(month,year)), year))
+    search = 0;
+    while (!Step(d))
+      yield();  // each step is slow: lets the urgent tasks run, see clock_tasks.h
+  }
+
+  boolean Step(long d) { // One step of the search for the Hebrew date of absolute date d, for a job in clock_jobs.h:
+                         // start with HebrewDate(0, 0, 0), returns true when done
+    if (search == 0) {
+      year = (d - HebrewEpoch) / 366; // Approximation from below.
+      search = 1;
+      return false;
+    }
+    if (search == 1) {
+      // Search forward for year from the approximation.
+      if (d >= HebrewDate(7,1,year + 1)) {
+        year++;
+        return false;
+      }
+      // Search forward for month from either Tishri or Nisan.
+      if (d < HebrewDate(1, 1, year))
+        month = 7;  //  Start at Tishri
+      else
+        month = 1;  //  Start at Nisan
+      search = 2;
+      return false;
+    }
+    if (d > HebrewDate(month, (LastDayOfHebrewMonth(month,year)), year)) {
       month++;
+      return false;
+    }
     // Calculate the day by subtraction.
     day = d - HebrewDate(month, 1, year) + 1;
+    return true;
   }
 
   operator long() { // Computes the absolute date of Hebrew date.
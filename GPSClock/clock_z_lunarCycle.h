@@ -20,6 +20,7 @@
           getSign
           localSiderealTime
           GetMoonLocation 
+          MoonLocationPart
           MoonTest
           moonInterpolate
 
@@ -303,46 +304,96 @@ static double moonTest(int k, double t0, double lat, double plx)
 /*
 * moon's position using fundamental arguments 
 * (Van Flandern & Pulkkinen, 1979)
+*
+* MoonLocationPart() is the same in MOON_LOCATION_PARTS calls, part = 0, 1, 2, for the slices of MoonRiseSetSlice():
+* the series v, then w, then u and the position. The arguments and the series are kept in the struct between them
 */
-static MOONLOCATION GetMoonLocation(double jd)
+#define MOON_LOCATION_PARTS 3
+
+typedef struct
+{
+    double  h, m, f, d, n, g;            // fundamental arguments
+    double  v, w;                        // series
+}
+MOONSERIES;
+
+static boolean MoonLocationPart
+(
+    double       jd,
+    uint8_t      part,                   // 0 ... MOON_LOCATION_PARTS - 1
+    MOONSERIES   *ms,
+    MOONLOCATION *itshere                // returned after the last part
+)                                        // returns true after the last part
 {
     double          d, f, g, h, m, n, s, u, v, w;
-    MOONLOCATION    itshere;
 
-    h = 0.606434 + 0.03660110129 * jd;
-    m = 0.374897 + 0.03629164709 * jd;
-    f = 0.259091 + 0.03674819520 * jd;
-    d = 0.827362 + 0.03386319198 * jd;
-    n = 0.347343 - 0.00014709391 * jd;
-    g = 0.993126 + 0.00273777850 * jd;
-
-    h = h - floor(h);
-    m = m - floor(m);
-    f = f - floor(f);
-    d = d - floor(d);
-    n = n - floor(n);
-    g = g - floor(g);
-
-    h = h*2*PI;
-    m = m*2*PI;
-    f = f*2*PI;
-    d = d*2*PI;
-    n = n*2*PI;
-    g = g*2*PI;
-
-    v = 0.39558 * sin(f + n);
-    v = v + 0.08200 * sin(f);
-    v = v + 0.03257 * sin(m - f - n);
-    v = v + 0.01092 * sin(m + f + n);
-    v = v + 0.00666 * sin(m - f);
-    v = v - 0.00644 * sin(m + f - 2*d + n);
-    v = v - 0.00331 * sin(f - 2*d + n);
-    v = v - 0.00304 * sin(f - 2*d);
-    v = v - 0.00240 * sin(m - f - 2*d - n);
-    v = v + 0.00226 * sin(m + f);
-    v = v - 0.00108 * sin(m + f - 2*d);
-    v = v - 0.00079 * sin(f - n);
-    v = v + 0.00078 * sin(f + 2*d + n);
+    if (part == 0)
+    {
+        h = 0.606434 + 0.03660110129 * jd;
+        m = 0.374897 + 0.03629164709 * jd;
+        f = 0.259091 + 0.03674819520 * jd;
+        d = 0.827362 + 0.03386319198 * jd;
+        n = 0.347343 - 0.00014709391 * jd;
+        g = 0.993126 + 0.00273777850 * jd;
+
+        h = h - floor(h);
+        m = m - floor(m);
+        f = f - floor(f);
+        d = d - floor(d);
+        n = n - floor(n);
+        g = g - floor(g);
+
+        h = h*2*PI;
+        m = m*2*PI;
+        f = f*2*PI;
+        d = d*2*PI;
+        n = n*2*PI;
+        g = g*2*PI;
+
+        v = 0.39558 * sin(f + n);
+        v = v + 0.08200 * sin(f);
+        v = v + 0.03257 * sin(m - f - n);
+        v = v + 0.01092 * sin(m + f + n);
+        v = v + 0.00666 * sin(m - f);
+        v = v - 0.00644 * sin(m + f - 2*d + n);
+        v = v - 0.00331 * sin(f - 2*d + n);
+        v = v - 0.00304 * sin(f - 2*d);
+        v = v - 0.00240 * sin(m - f - 2*d - n);
+        v = v + 0.00226 * sin(m + f);
+        v = v - 0.00108 * sin(m + f - 2*d);
+        v = v - 0.00079 * sin(f - n);
+        v = v + 0.00078 * sin(f + 2*d + n);
+
+        ms->h = h; ms->m = m; ms->f = f; ms->d = d; ms->n = n; ms->g = g;
+        ms->v = v;
+        return false;
+    }
+
+    h = ms->h; m = ms->m; f = ms->f; d = ms->d; n = ms->n; g = ms->g;
+
+    if (part == 1)
+    {
+        w = 0.10478 * sin(m);
+        w = w - 0.04105 * sin(2*f + 2*n);
+        w = w - 0.02130 * sin(m - 2*d);
+        w = w - 0.01779 * sin(2*f + n);
+        w = w + 0.01774 * sin(n);
+        w = w + 0.00987 * sin(2*d);
+        w = w - 0.00338 * sin(m - 2*f - 2*n);
+        w = w - 0.00309 * sin(g);
+        w = w - 0.00190 * sin(2*f);
+        w = w - 0.00144 * sin(m + n);
+        w = w - 0.00144 * sin(m - 2*f - n);
+        w = w - 0.00113 * sin(m + 2*f + 2*n);
+        w = w - 0.00094 * sin(m - 2*d + g);
+        w = w - 0.00092 * sin(2*m - 2*d);
+
+        ms->w = w;
+        return false;
+    }
+
+    v = ms->v;
+    w = ms->w;
 
     u = 1 - 0.10828 * cos(m);
     u = u - 0.01880 * cos(m - 2*d);
@@ -352,29 +403,23 @@ static MOONLOCATION GetMoonLocation(double jd)
     u = u - 0.00105 * cos(2*d - g);
     u = u - 0.00075 * cos(m - 2*d + g);
 
-    w = 0.10478 * sin(m);
-    w = w - 0.04105 * sin(2*f + 2*n);
-    w = w - 0.02130 * sin(m - 2*d);
-    w = w - 0.01779 * sin(2*f + n);
-    w = w + 0.01774 * sin(n);
-    w = w + 0.00987 * sin(2*d);
-    w = w - 0.00338 * sin(m - 2*f - 2*n);
-    w = w - 0.00309 * sin(g);
-    w = w - 0.00190 * sin(2*f);
-    w = w - 0.00144 * sin(m + n);
-    w = w - 0.00144 * sin(m - 2*f - n);
-    w = w - 0.00113 * sin(m + 2*f + 2*n);
-    w = w - 0.00094 * sin(m - 2*d + g);
-    w = w - 0.00092 * sin(2*m - 2*d);
-
     s = w/sqrt(u - v*v);                  // compute moon's  ...  right ascension
-    itshere.rightascension = h + atan(s/sqrt(1 - s*s));
+    itshere->rightascension = h + atan(s/sqrt(1 - s*s));
 
     s = v/sqrt(u);                        // declination ...
-    itshere.declination = atan(s/sqrt(1 - s*s));
+    itshere->declination = atan(s/sqrt(1 - s*s));
 
-    itshere.parallax = 60.40974 * sqrt( u );          // and parallax
+    itshere->parallax = 60.40974 * sqrt( u );          // and parallax
 
+    return true;
+}
+
+static MOONLOCATION GetMoonLocation(double jd)
+{
+    MOONSERIES      ms;
+    MOONLOCATION    itshere;
+
+    for (uint8_t part = 0; !MoonLocationPart(jd, part, &ms, &itshere); part++);
     return(itshere);
 }
 
@@ -425,81 +470,125 @@ char *lunarPhaseGet (char *increase, char *decrease, char *full)
 // packedRise = packedSet = -1      =>  the moon never sets
 // packedRise = packedSet = -2      =>  the moon never rises
 
-void GetMoonRiseSetTimes
+// Resumable version, for a job in clock_jobs.h: MOON_RISE_SET_SLICES calls of MoonRiseSetSlice() of a few ms each,
+// slice = 0, 1, 2... The interpolation state (VHz[], RAn[], Decl[], MoonRise, MoonSet) is kept in the struct
+// between slices, as other computations may use these globals in the meantime
+
+#define MOON_RISE_SET_HOURS      1                              // hours tested per slice, 6 to 11 sin, cos...
+#define MOON_RISE_SET_HOUR_SLICE (1 + 3 * MOON_LOCATION_PARTS)  // the first of them
+#define MOON_RISE_SET_SLICES     (MOON_RISE_SET_HOUR_SLICE + 24 / MOON_RISE_SET_HOURS)  // sidereal time, 3 moon positions, 24 hours
+
+typedef struct
+{
+    double          day;                 // input: UTC day, days since 1970
+    double          zone, lat, lon;      // input: as for GetMoonRiseSetTimes()
+    double          jd, localsidereal;
+    MOONSERIES      ms;
+    MOONLOCATION    mp[3];
+    double          VHz[3], RAn[3], Decl[3];
+    MOONRISESET     rise, set;
+}
+MOONRISESETWORK;
+
+boolean MoonRiseSetSlice
 (
-    double       zone,                   // Timezone offset from UTC/GMT in hours
-    double       lat,                    // Latitude degress  N=> +, S=> -
-    double       lon,                    // longitude degress E=> +, W=> -
-    short        *packedRise,            // returned Moon Rise time
+    MOONRISESETWORK *w,
+    uint8_t      slice,                  // 0 ... MOON_RISE_SET_SLICES - 1
+    short        *packedRise,            // returned Moon Rise time, after the last slice
     double       *riseAz,                // return Moon Rise Azimuth
     short        *packedSet,             // returned Moon Set time
     double       *setAz                  // return Moon Set Azimuth
-)
+)                                        // returns true after the last slice
 {
     int             k;
-    MOONLOCATION    mp[3];
-    double          localsidereal;
     double          ph;
-    double          jd;
-
-    // Julian day converted to J2000, i.e. relative to Jan 1.5, 2000
-    // GetJulianDate() suffers from precision problem on Arduino as double = single = float
-    //jd = GetJulianDate(year, month, (double)day) - 2451545.0;
-    
-    // should indicate beginning of the day, hence the truncation --- but why beginning of day?
-    jd = trunc(now()/86400.0) - 10957.5; // i.e. no of days since 1970 converted to j2000
-
-    //jd = trunc(8001.48); // 27.11.2021
-    
-    localsidereal = localSiderealTime(lon, jd, zone); // local sidereal time
-    
-  
-    #ifdef FEATURE_SERIAL_MOON
-      Serial.println(F("GetMoonRiseSetTimes: "));
-      Serial.print(F(" jd, zone, localsidereal ")); //, year, month, day: "));
-      Serial.print(jd);Serial.print(F(", "));Serial.print(zone);Serial.print(F(", "));Serial.println(localsidereal);
-    #endif
 
-    jd = jd - zone / 24.0;                      // get moon position at day start
+    if (slice == 0)
+    {
+        // Julian day converted to J2000, i.e. relative to Jan 1.5, 2000
+        // GetJulianDate() suffers from precision problem on Arduino as double = single = float
+        //jd = GetJulianDate(year, month, (double)day) - 2451545.0;
+
+        // should indicate beginning of the day, hence the truncation --- but why beginning of day?
+        w->jd = w->day - 10957.5; // i.e. no of days since 1970 converted to j2000
+
+        //jd = trunc(8001.48); // 27.11.2021
+
+        w->localsidereal = localSiderealTime(w->lon, w->jd, w->zone); // local sidereal time
 
-    for (k = 0; k < 3; k ++)
+        #ifdef FEATURE_SERIAL_MOON
+          Serial.println(F("GetMoonRiseSetTimes: "));
+          Serial.print(F(" jd, zone, localsidereal ")); //, year, month, day: "));
+          Serial.print(w->jd);Serial.print(F(", "));Serial.print(w->zone);Serial.print(F(", "));Serial.println(w->localsidereal);
+        #endif
+
+        w->jd = w->jd - w->zone / 24.0;         // get moon position at day start
+        return false;
+    }
+
+    if (slice < MOON_RISE_SET_HOUR_SLICE)
     {
-        mp[k] = GetMoonLocation(jd);
-        jd = jd + 0.5;                           // increase by half a day
+        if (MoonLocationPart(w->jd, (slice - 1) % MOON_LOCATION_PARTS, &w->ms, &w->mp[(slice - 1) / MOON_LOCATION_PARTS]))
+            w->jd = w->jd + 0.5;                 // increase by half a day
+        return false;
     }
 
-    if (mp[1].rightascension <= mp[0].rightascension)
-        mp[1].rightascension = mp[1].rightascension + 2*PI;
+    if (slice == MOON_RISE_SET_HOUR_SLICE)
+    {
+        if (w->mp[1].rightascension <= w->mp[0].rightascension)
+            w->mp[1].rightascension = w->mp[1].rightascension + 2*PI;
+
+        if (w->mp[2].rightascension <= w->mp[1].rightascension)
+            w->mp[2].rightascension = w->mp[2].rightascension + 2*PI;
+
+        memcpy(w->VHz, VHz, sizeof(VHz));
+        memcpy(w->RAn, RAn, sizeof(RAn));
+        memcpy(w->Decl, Decl, sizeof(Decl));
+        w->rise = MoonRise;
+        w->set = MoonSet;
 
-    if (mp[2].rightascension <= mp[1].rightascension)
-        mp[2].rightascension = mp[2].rightascension + 2*PI;
+        w->RAn[0] = w->mp[0].rightascension;
+        w->Decl[0] = w->mp[0].declination;
 
-    RAn[0] = mp[0].rightascension;
-    Decl[0] = mp[0].declination;
+        w->rise.event = 0;                       // initialize
+        w->set.event  = 0;
+    }
 
-    MoonRise.event = 0;                         // initialize
-    MoonSet.event  = 0;
+    memcpy(VHz, w->VHz, sizeof(VHz));
+    memcpy(RAn, w->RAn, sizeof(RAn));
+    memcpy(Decl, w->Decl, sizeof(Decl));
+    MoonRise = w->rise;
+    MoonSet = w->set;
 
-    for (k = 0; k < 24; k++)                    // check each hour of this day
+    for (k = MOON_RISE_SET_HOURS * (slice - MOON_RISE_SET_HOUR_SLICE);  // check each hour of this day
+         k < MOON_RISE_SET_HOURS * (slice - MOON_RISE_SET_HOUR_SLICE + 1); k++)
     {
         ph = (k + 1.0)/24.0;
 
-        RAn[2] = moonInterpolate(mp[0].rightascension, 
-                                 mp[1].rightascension, 
-                                 mp[2].rightascension, 
+        RAn[2] = moonInterpolate(w->mp[0].rightascension, 
+                                 w->mp[1].rightascension, 
+                                 w->mp[2].rightascension, 
                                  ph);
-        Decl[2] = moonInterpolate(mp[0].declination, 
-                                 mp[1].declination, 
-                                 mp[2].declination, 
+        Decl[2] = moonInterpolate(w->mp[0].declination, 
+                                 w->mp[1].declination, 
+                                 w->mp[2].declination, 
                                  ph);
 
-        VHz[2] = moonTest(k, localsidereal, lat, mp[1].parallax);
+        VHz[2] = moonTest(k, w->localsidereal, w->lat, w->mp[1].parallax);
 
         RAn[0] = RAn[2];                       // advance to next hour
         Decl[0] = Decl[2];
         VHz[0] = VHz[2];
     }
 
+    memcpy(w->VHz, VHz, sizeof(VHz));
+    memcpy(w->RAn, RAn, sizeof(RAn));
+    memcpy(w->Decl, Decl, sizeof(Decl));
+    w->rise = MoonRise;
+    w->set = MoonSet;
+
+    if (slice < MOON_RISE_SET_SLICES - 1) return false;
+
     *packedRise = (short)(MoonRise.hr * 100 +  MoonRise.min);
     if (riseAz != NULL)
         *riseAz = MoonRise.az;
@@ -532,5 +621,27 @@ void GetMoonRiseSetTimes
       Serial.print(MoonSet.hr);Serial.print(F(", "));Serial.println(MoonSet.min);
     #endif
 
-    return; // ; ????????????
+    return true;
 }
+
+void GetMoonRiseSetTimes
+(
+    double       zone,                   // Timezone offset from UTC/GMT in hours
+    double       lat,                    // Latitude degress  N=> +, S=> -
+    double       lon,                    // longitude degress E=> +, W=> -
+    short        *packedRise,            // returned Moon Rise time
+    double       *riseAz,                // return Moon Rise Azimuth
+    short        *packedSet,             // returned Moon Set time
+    double       *setAz                  // return Moon Set Azimuth
+)
+{
+    MOONRISESETWORK w;
+
+    w.day = trunc(now()/86400.0);
+    w.zone = zone;
+    w.lat = lat;
+    w.lon = lon;
+
+    for (uint8_t slice = 0; !MoonRiseSetSlice(&w, slice, packedRise, riseAz, packedSet, setAz); slice++);
+}
+
@@ -10,14 +10,21 @@
     Visit subsystems.us for more fun Arduino and science projets.
 */
 
-void MoonEclipse( int tYear, // input year
-                  int pDate[], // output packed time: 100*month + day
-                  int EclipseYear[] // this routine gives a date in 2028 when tYear = 2027, 2029
-                  ) 
+// Resumable version, for a job in clock_jobs.h: MoonEclipseYear() once, then MoonEclipseFullMoon() for each of the
+// ECLIPSE_FULL_MOONS full moons, about a ms each
+
+#define ECLIPSE_FULL_MOONS 14  // K9 = 1, 3, ... 27
+
+struct EclipseYearData
+{
+  float Ta, J0, F0, M0, M1, B1a;
+};
+
+void MoonEclipseYear( int tYear, // input year
+                      EclipseYearData *e
+                      )
   {
   float Ya = tYear;
-  float U = 0;
-  float Rad1 = 3.14159265 / 180;
   float K0 = (long)((Ya - 1900) * 12.3685);
   float Ta = (Ya - 1899.5) / 100;
   float T2 = Ta * Ta;
@@ -41,9 +48,26 @@ void MoonEclipse( int tYear, // input year
   B1a = B1a - 0.0016528 * T2;
   B1a = B1a - 0.00000239 * T3;
 
+  e->Ta = Ta;
+  e->J0 = J0;
+  e->F0 = F0;
+  e->M0 = M0;
+  e->M1 = M1;
+  e->B1a = B1a;
+}
+
+int MoonEclipseFullMoon( const EclipseYearData *e,
+                         int K9, // 1, 3, ... 27
+                         int pDate[], // output packed time of an eclipse: 100*month + day, in pDate[0]
+                         int EclipseYear[]
+                         ) // returns 1 if there is an eclipse at this full moon, else 0
+  {
+  float U = 0;
+  float Rad1 = 3.14159265 / 180;
+  float Ta = e->Ta, J0 = e->J0, F0 = e->F0, M0 = e->M0, M1 = e->M1, B1a = e->B1a;
   int dateCounter = 0;
-  
-  for (int K9 = 1; K9 < 28; K9 = K9 + 2) {
+
+  {
     float J = J0 + 14 * K9;
     float F = F0 + 0.765294 * K9;
     float K = (float)K9 / 2.0;
@@ -86,7 +110,7 @@ void MoonEclipse( int tYear, // input year
       float RU = 0.7404 - U;                  // Meeus: umbra
       float MP = (1.5572 + U - D9) / 0.545;   // Meeus: penumbral eclipse
       
-      if (MP < 0) continue;                   // continue <=> break out of loop
+      if (MP < 0) return 0;                   // no eclipse at this full moon
       float MU = (1.0129 - U - D9) / 0.545;   // Meeus: umbral eclipse
       
       float D5 = 1.5572 + U;
@@ -164,6 +188,23 @@ void MoonEclipse( int tYear, // input year
 #endif
     }
   }
+
+  return dateCounter;
+}
+
+void MoonEclipse( int tYear, // input year
+                  int pDate[], // output packed time: 100*month + day
+                  int EclipseYear[] // this routine gives a date in 2028 when tYear = 2027, 2029
+                  ) 
+  {
+  EclipseYearData e;
+  MoonEclipseYear(tYear, &e);
+
+  int dateCounter = 0;
+  
+  for (int K9 = 1; K9 < 28; K9 = K9 + 2) {
+    dateCounter = dateCounter + MoonEclipseFullMoon(&e, K9, &pDate[dateCounter], &EclipseYear[dateCounter]);
+  }
   
   pDate[dateCounter] = 0;
 }
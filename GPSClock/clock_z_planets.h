@@ -390,86 +390,119 @@ void calc_orbital_coordinates (float semiMajorAxis, float eccentricity, float ec
 // =========================================================================
 // object position
 // =========================================================================
-void get_object_position (int object_number, float jd, float jd_frac) {
+// Resumable version, for a job in clock_jobs.h: OBJECT_POSITION_PARTS calls of get_object_position_part() of up to
+// about 16 sin, cos, atan2... each, part = 0, 1, 2... What a part leaves for the next one is kept in the struct, as
+// other computations may use the globals in the meantime. For the planets, x_earth, y_earth, z_earth and
+// dist_earth_to_sun must be those of the earth, object 2, which are known after its first OBJECT_POSITION_EARTH parts
+
+#define OBJECT_POSITION_PARTS 5  // orbital elements and Kepler equation, orbit, heliocentric, geocentric, azimuthal
+#define OBJECT_POSITION_EARTH 4  // the parts up to the geocentric coordinates
+
+struct object_position_work {
+  float semiMajorAxis, eccentricity, eccentricAnomaly;
+  float inclination, argumentPerihelion, longitudeAscendingNode;
+  float x, y, z;  // x_coord, y_coord, z_coord
+  float ra, dec, dist_earth_to_object, dist_object_to_sun;
+};
 
-  #ifdef FEATURE_SERIAL_PLANETARY 
-    Serial.println(F("----------------------------------------------------"));
-    ////Serial.println("Object: " + object_name[object_number]);
-    //Serial.println("Object: " + object_number);  // removed 16.09.2024
-    Serial.print("Object: ");
-    Serial.println(object_number);
-  #endif
+boolean get_object_position_part (int object_number, float jd, float jd_frac, uint8_t part, object_position_work *w) {  // returns true after the last part
 
-  float T = jd - 2451545;
-  T += jd_frac;
-  T /= 36525;
-  #ifdef FEATURE_SERIAL_PLANETARY
-    Serial.println("T:" + String(T, DEC));
-  #endif
+  if (part == 0) {
+    #ifdef FEATURE_SERIAL_PLANETARY 
+      Serial.println(F("----------------------------------------------------"));
+      ////Serial.println("Object: " + object_name[object_number]);
+      //Serial.println("Object: " + object_number);  // removed 16.09.2024
+      Serial.print("Object: ");
+      Serial.println(object_number);
+    #endif
 
-  float sidereal_time = calc_siderealTime (jd, jd_frac, lon);  // changed back to lon from lonPlanet 22.09.2024
-  #ifdef FEATURE_SERIAL_PLANETARY
-    Serial.println("ST:" + String(sidereal_time, DEC));
-    Serial.println("lon:" + String(lon, DEC));
-    Serial.println("lat:" + String(latitude, DEC));
-  #endif
+    float T = jd - 2451545;
+    T += jd_frac;
+    T /= 36525;
+    #ifdef FEATURE_SERIAL_PLANETARY
+      Serial.println("T:" + String(T, DEC));
+    #endif
 
-  float semiMajorAxis = object_data[object_number][0] + (T * object_data[object_number][1]); // offset + T * delta
-  float eccentricity = object_data[object_number][2] + (T * object_data[object_number][3]);
-  float inclination = object_data[object_number][4] + (T * object_data[object_number][5]);
-  float meanLongitude = object_data[object_number][6] + (T * object_data[object_number][7]);
-  float longitudePerihelion = object_data[object_number][8] + (T * object_data[object_number][9]);
-  float longitudeAscendingNode = object_data[object_number][10] + (T * object_data[object_number][11]);
-  float meanAnomaly = meanLongitude - longitudePerihelion;
-  float argumentPerihelion = longitudePerihelion - longitudeAscendingNode;
+    float semiMajorAxis = object_data[object_number][0] + (T * object_data[object_number][1]); // offset + T * delta
+    float eccentricity = object_data[object_number][2] + (T * object_data[object_number][3]);
+    float inclination = object_data[object_number][4] + (T * object_data[object_number][5]);
+    float meanLongitude = object_data[object_number][6] + (T * object_data[object_number][7]);
+    float longitudePerihelion = object_data[object_number][8] + (T * object_data[object_number][9]);
+    float longitudeAscendingNode = object_data[object_number][10] + (T * object_data[object_number][11]);
+    float meanAnomaly = meanLongitude - longitudePerihelion;
+    float argumentPerihelion = longitudePerihelion - longitudeAscendingNode;
 
-  #ifdef FEATURE_SERIAL_PLANETARY
-    if (full) Serial.println("semiMajorAxis:" + String(semiMajorAxis, DEC));
-    if (full) Serial.println("eccentricity:" + String(eccentricity, DEC));
-  #endif
+    #ifdef FEATURE_SERIAL_PLANETARY
+      if (full) Serial.println("semiMajorAxis:" + String(semiMajorAxis, DEC));
+      if (full) Serial.println("eccentricity:" + String(eccentricity, DEC));
+    #endif
    
-  inclination = calc_format_angle_deg (inclination);
-  #ifdef FEATURE_SERIAL_PLANETARY
-    if (full) Serial.println("inclination:" + String(inclination, DEC));
-  #endif
+    inclination = calc_format_angle_deg (inclination);
+    #ifdef FEATURE_SERIAL_PLANETARY
+      if (full) Serial.println("inclination:" + String(inclination, DEC));
+    #endif
 
-  meanLongitude = calc_format_angle_deg (meanLongitude);
-  longitudePerihelion = calc_format_angle_deg (longitudePerihelion);
-  longitudeAscendingNode = calc_format_angle_deg (longitudeAscendingNode);
-  meanAnomaly = calc_format_angle_deg (meanAnomaly);
-  argumentPerihelion = calc_format_angle_deg (argumentPerihelion);
+    meanLongitude = calc_format_angle_deg (meanLongitude);
+    longitudePerihelion = calc_format_angle_deg (longitudePerihelion);
+    longitudeAscendingNode = calc_format_angle_deg (longitudeAscendingNode);
+    meanAnomaly = calc_format_angle_deg (meanAnomaly);
+    argumentPerihelion = calc_format_angle_deg (argumentPerihelion);
   
-  #ifdef FEATURE_SERIAL_PLANETARY
-    if (full) Serial.println("meanLongitude:" + String(meanLongitude, DEC));
-    if (full) Serial.println("longitudePerihelion:" + String(longitudePerihelion, DEC));
-    if (full) Serial.println("longitudeAscendingNode:" + String(longitudeAscendingNode, DEC));
-    if (full) Serial.println("meanAnomaly:" + String(meanAnomaly, DEC));
-    if (full) Serial.println("argumentPerihelion:" + String(argumentPerihelion, DEC));
-  #endif  
-  //---------------------------------
-  float eccentricAnomaly = calc_eccentricAnomaly(meanAnomaly, eccentricity);
-  eccentricAnomaly = calc_format_angle_deg (eccentricAnomaly);
-  #ifdef FEATURE_SERIAL_PLANETARY
-    if (full) Serial.println("eccentricAnomaly:" + String(eccentricAnomaly, DEC));
-  #endif
-  //---------------------------------
-  //to orbital Coordinates:
-  #ifdef FEATURE_SERIAL_PLANETARY
-    if (full) Serial.println(F("orbital coordinates:"));
-  #endif
-  calc_orbital_coordinates (semiMajorAxis, eccentricity, eccentricAnomaly);
-  //---------------------------------
-  //to heliocentric ecliptic coordinates:
-  rot_z (argumentPerihelion);
-  rot_x (inclination);
-  rot_z (longitudeAscendingNode);
-  // #ifdef FEATURE_SERIAL_PLANETARY  // added 16.09.2024:
-  //     Serial.print(F("Object #: "));
-  //     Serial.println(object_number);
-  // #endif
+    #ifdef FEATURE_SERIAL_PLANETARY
+      if (full) Serial.println("meanLongitude:" + String(meanLongitude, DEC));
+      if (full) Serial.println("longitudePerihelion:" + String(longitudePerihelion, DEC));
+      if (full) Serial.println("longitudeAscendingNode:" + String(longitudeAscendingNode, DEC));
+      if (full) Serial.println("meanAnomaly:" + String(meanAnomaly, DEC));
+      if (full) Serial.println("argumentPerihelion:" + String(argumentPerihelion, DEC));
+    #endif  
+    //---------------------------------
+    float eccentricAnomaly = calc_eccentricAnomaly(meanAnomaly, eccentricity);
+    eccentricAnomaly = calc_format_angle_deg (eccentricAnomaly);
+    #ifdef FEATURE_SERIAL_PLANETARY
+      if (full) Serial.println("eccentricAnomaly:" + String(eccentricAnomaly, DEC));
+    #endif
+
+    w->semiMajorAxis = semiMajorAxis;
+    w->eccentricity = eccentricity;
+    w->eccentricAnomaly = eccentricAnomaly;
+    w->inclination = inclination;
+    w->argumentPerihelion = argumentPerihelion;
+    w->longitudeAscendingNode = longitudeAscendingNode;
+  }
+
+  if (part > 0) {  // what the part before left
+    x_coord = w->x;
+    y_coord = w->y;
+    z_coord = w->z;
+    ra = w->ra;
+    dec = w->dec;
+    dist_earth_to_object = w->dist_earth_to_object;
+    dist_object_to_sun = w->dist_object_to_sun;
+  }
+
+  if (part == 1) {
+    //---------------------------------
+    //to orbital Coordinates:
+    #ifdef FEATURE_SERIAL_PLANETARY
+      if (full) Serial.println(F("orbital coordinates:"));
+    #endif
+    calc_orbital_coordinates (w->semiMajorAxis, w->eccentricity, w->eccentricAnomaly);
+  }
+
+  if (part == 2) {
+    //---------------------------------
+    //to heliocentric ecliptic coordinates:
+    rot_z (w->argumentPerihelion);
+    rot_x (w->inclination);
+    rot_z (w->longitudeAscendingNode);
+    // #ifdef FEATURE_SERIAL_PLANETARY  // added 16.09.2024:
+    //     Serial.print(F("Object #: "));
+    //     Serial.println(object_number);
+    // #endif
+  }
 
   //---------------------------------
-  if (object_number == 2) {//object earth
+  if (part == 3 && object_number == 2) {//object earth
 
     x_earth = x_coord;
     y_earth = y_coord;
@@ -487,10 +520,9 @@ void get_object_position (int object_number, float jd, float jd_frac) {
     rot_x (eclipticAngle);//rotate x > earth ecliptic angle
     calc_vector(x_coord, y_coord, z_coord, "");
     dist_earth_to_sun = dist_earth_to_object;
-    calc_azimuthal_position(ra, dec, latitude, sidereal_time);
   }
   //---------------------------------
-  if (object_number != 2) {//all other objects
+  if (part == 3 && object_number != 2) {//all other objects
     
     calc_vector_subtract(x_earth, x_coord , y_earth, y_coord, z_earth , z_coord);// earth - object coordinates
     calc_vector(x_coord, y_coord, z_coord, "");
@@ -500,9 +532,35 @@ void get_object_position (int object_number, float jd, float jd_frac) {
     #endif
     rot_x (eclipticAngle);//rotate x > earth ecliptic angle
     calc_vector(x_coord, y_coord, z_coord, "");
-    calc_azimuthal_position(ra, dec, latitude, sidereal_time);
-    calc_magnitude(object_number, dist_earth_to_object);
   }
+
+  if (part < OBJECT_POSITION_PARTS - 1) {
+    w->x = x_coord;
+    w->y = y_coord;
+    w->z = z_coord;
+    w->ra = ra;
+    w->dec = dec;
+    w->dist_earth_to_object = dist_earth_to_object;
+    w->dist_object_to_sun = dist_object_to_sun;
+    return false;
+  }
+
+  float sidereal_time = calc_siderealTime (jd, jd_frac, lon);  // changed back to lon from lonPlanet 22.09.2024
+  #ifdef FEATURE_SERIAL_PLANETARY
+    Serial.println("ST:" + String(sidereal_time, DEC));
+    Serial.println("lon:" + String(lon, DEC));
+    Serial.println("lat:" + String(latitude, DEC));
+  #endif
+
+  calc_azimuthal_position(ra, dec, latitude, sidereal_time);
+  if (object_number != 2) calc_magnitude(object_number, dist_earth_to_object);
+  return true;
+}
+
+void get_object_position (int object_number, float jd, float jd_frac) {
+  object_position_work w;
+
+  for (uint8_t part = 0; !get_object_position_part(object_number, jd, jd_frac, part, &w); part++);
 }
 
 